@@ -8,13 +8,20 @@ import time
 from typing import Any, Dict, Optional
 
 
+# Responses arrive as a burst of MTU sized chunks, so the socket needs room to queue all of them while the first ones
+# are being read
+RECEIVE_BUFFER_SIZE = 1 << 20
+
+
 class TssUdpClient:
     """Minimal UDP GET client matching TSS wire format."""
 
     def __init__(self, host: str, port: int, timeout_s: float, retries: int) -> None:
         self._retries = retries
+        self._timeout_s = timeout_s
         self._lock = threading.Lock()
         self._socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self._socket.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, RECEIVE_BUFFER_SIZE)
         self._socket.settimeout(timeout_s)
         self._socket.connect((host, port))
 
@@ -26,8 +33,9 @@ class TssUdpClient:
         for _ in range(self._retries):
             try:
                 with self._lock:
+                    self._discard_pending()
                     self._socket.send(packet)
-                    raw = self._socket.recv(65535)
+                    raw = self._receive_response()
                 return self._decode_response(raw)
             except (TimeoutError, socket.timeout):
                 continue
@@ -35,13 +43,52 @@ class TssUdpClient:
                 break
         return None
 
+    def _discard_pending(self) -> None:
+        """Drop datagrams left over from an attempt that timed out.
+
+        Late chunks of that response can carry the same version as the next
+        one, so they would otherwise be reassembled into it.
+        """
+        self._socket.setblocking(False)
+        try:
+            while True:
+                self._socket.recv(65535)
+        except OSError:
+            pass
+        finally:
+            self._socket.settimeout(self._timeout_s)
+
+    def _receive_response(self) -> bytes:
+        """Receive every chunk of a response and return the reassembled payload.
+
+        Each datagram starts with an 8 byte header: chunk index (uint16), chunk
+        count (uint16) and data version (uint32), all big endian.
+        """
+        chunks: Dict[int, bytes] = {}
+        chunk_count = 1
+        version = None
+        while len(chunks) < chunk_count:
+            raw = self._socket.recv(65535)
+            if len(raw) < 8:
+                return raw
+            index, count, chunk_version = struct.unpack(">HHI", raw[:8])
+            if index >= max(count, 1):
+                # Not a chunk of any valid response
+                continue
+            if version != chunk_version or chunk_count != max(count, 1):
+                # A chunk of a newer (or stale) response, start over with it
+                chunks = {}
+                version = chunk_version
+            chunk_count = max(count, 1)
+            chunks[index] = raw[8:]
+        return b"".join(chunks[i] for i in range(chunk_count))
+
     @staticmethod
     def _decode_response(raw: bytes) -> Optional[Dict[str, Any]]:
         if not raw:
             return None
 
-        payload = raw[8:] if len(raw) > 8 else raw
-        payload = payload.split(b"\x00", 1)[0].strip()
+        payload = raw.split(b"\x00", 1)[0].strip()
         if not payload:
             return None
 
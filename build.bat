@@ -1 +1 @@
-gcc -g src/network.c src/data.c src/server.c src/lib/simulation/throw_errors.c src/lib/cjson/cJSON.c src/lib/simulation/sim_engine.c src/lib/simulation/sim_algorithms.c -o server.exe -lm
\ No newline at end of file
+gcc -g src/network.c src/http.c src/data.c src/server.c src/store.c src/lib/simulation/throw_errors.c src/lib/cjson/cJSON.c src/lib/gzip/gzip.c src/lib/simulation/sim_engine.c src/lib/simulation/sim_algorithms.c -o server.exe -lm -lpthread
\ No newline at end of file
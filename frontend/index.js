@@ -1,6 +1,8 @@
 // GLOBAL VARIABLES
 let connectionFails = 0; // number of consecutive connection failures, resets on successful fetch
 let dustConnected = false; // tracks DUST/Unreal Engine connection status
+let telemetryStream = null; // EventSource connected to /stream, null when falling back to fetching the files
+const telemetryData = { eva: null, rover: null, ltv: null }; // latest data received for each dataset
 
 
 
@@ -10,9 +12,19 @@ let dustConnected = false; // tracks DUST/Unreal Engine connection status
 function onload() {
   updateClock(); // set clock immediately on load (will be updated every second later)
 
+  // Receive data from the backend as it changes, older browsers fetch the files instead
+  if (window.EventSource) {
+    openTelemetryStream();
+  }
+
   // Fetch fresh data from the backend every one second
   setInterval(() => {
-    fetchData();
+    if (telemetryStream) {
+      // EventSource reconnects on its own, the stream only counts as failed while it is not open
+      connectionFails = telemetryStream.readyState === EventSource.OPEN ? 0 : connectionFails + 1;
+    } else {
+      fetchData();
+    }
     updateClock();
     updateTelemetryStatus();
     updateDustStatus();
@@ -25,6 +37,62 @@ function onload() {
 
 // DATA MANAGEMENT
 
+/**
+ * Opens the Server-Sent Events stream, the server sends an event named after each dataset (EVA, ROVER, LTV)
+ * with the full JSON, followed by "<dataset>-delta" events that only hold the fields that changed since.
+ * The page no longer polls the JSON files.
+ */
+function openTelemetryStream() {
+  telemetryStream = new EventSource("/stream?deltas=1");
+
+  const datasets = { EVA: "eva", ROVER: "rover", LTV: "ltv" };
+  Object.entries(datasets).forEach(([event, key]) => {
+    telemetryStream.addEventListener(event, (message) => {
+      onTelemetryEvent(event, message, (data) => {
+        telemetryData[key] = data;
+      });
+    });
+
+    // Deltas always follow a full event on the same connection, so there is always something to merge into
+    telemetryStream.addEventListener(`${event}-delta`, (message) => {
+      onTelemetryEvent(event, message, (delta) => {
+        mergeDelta(telemetryData[key], delta);
+      });
+    });
+  });
+}
+
+/**
+ * Parses a telemetry stream event, applies it with the given callback, and refreshes the page
+ */
+function onTelemetryEvent(event, message, apply) {
+  try {
+    apply(JSON.parse(message.data));
+  } catch (error) {
+    console.error(`Invalid ${event} data on telemetry stream:`, error);
+    return;
+  }
+  connectionFails = 0;
+  updateFromTelemetry();
+}
+
+/**
+ * Applies a JSON merge patch from the server: nested objects are merged, null removes a field,
+ * and every other value replaces the current one
+ */
+function mergeDelta(target, delta) {
+  Object.entries(delta).forEach(([name, value]) => {
+    if (value === null) {
+      delete target[name];
+    } else if (typeof value === "object" && !Array.isArray(value) &&
+               typeof target[name] === "object" && target[name] !== null && !Array.isArray(target[name])) {
+      mergeDelta(target[name], value);
+    } else {
+      target[name] = value;
+    }
+  });
+}
+
 /**
  * Fetches the latest EVA and ROVER data and updates the DOM elements accordingly.
  * In the html, there is a data-path attribute on the elements that basically registers that field as needing to be updated with data from the server
@@ -63,19 +131,35 @@ async function fetchData() {
       ltvResponse.json(),
     ]);
 
-    //check if telemetry component has been started by seeing if EVA.status.started is true
-    evaStarted = evaData?.status?.started === true;
-
     connectionFails = 0;
-    dustConnected =
-      (roverData?.pr_telemetry?.dust_connected && connectionFails <= 2) ||
-      false;
   } catch (error) {
     console.error("Fatal error fetching data:", error);
     connectionFails++;
     return;
   }
 
+  telemetryData.eva = evaData;
+  telemetryData.rover = roverData;
+  telemetryData.ltv = ltvData;
+  updateFromTelemetry();
+}
+
+/**
+ * Updates the DOM elements from the latest EVA, ROVER, and LTV data, wherever that data came from
+ */
+function updateFromTelemetry() {
+  const { eva: evaData, rover: roverData, ltv: ltvData } = telemetryData;
+  if (!evaData || !roverData || !ltvData) {
+    return; // wait until every dataset has arrived once
+  }
+
+  //check if telemetry component has been started by seeing if EVA.status.started is true
+  evaStarted = evaData?.status?.started === true;
+
+  dustConnected =
+    (roverData?.pr_telemetry?.dust_connected && connectionFails <= 2) ||
+    false;
+
   // Update the EVA, ROVER, and LTV fields in the DOM
   const elements = document.querySelectorAll("[data-path]");
   elements.forEach((el) => {
@@ -0,0 +1,100 @@
+import ctypes
+import gzip
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+# Round-trip check for the DEFLATE encoder in src/lib/gzip: compresses a set of inputs with gzip_compress and
+# decompresses them with Python's gzip module, which also checks the CRC and length in the trailer.
+# The inputs make the encoder pick stored, fixed Huffman, and dynamic Huffman blocks, and include bytes 0x90
+# and above, whose fixed codes are 9 bits long.
+#
+# Needs gcc, run from the repository root:
+#   python scripts/check_gzip.py
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+BLOCK_TYPES = ["stored", "fixed", "dynamic", "invalid"]
+
+
+def load_encoder(directory):
+    library = os.path.join(directory, "gzip.so")
+    subprocess.run(["gcc", "-shared", "-fPIC", "-O2", os.path.join(ROOT, "src", "lib", "gzip", "gzip.c"),
+                    "-o", library], check=True)
+
+    encoder = ctypes.CDLL(library)
+    encoder.gzip_compress.restype = ctypes.c_void_p
+    encoder.gzip_compress.argtypes = [ctypes.c_char_p, ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t)]
+    return encoder
+
+
+def compress(encoder, data):
+    length = ctypes.c_size_t(0)
+    pointer = encoder.gzip_compress(data, len(data), ctypes.byref(length))
+    if not pointer:
+        raise MemoryError("gzip_compress returned NULL")
+
+    compressed = ctypes.string_at(pointer, length.value)
+    ctypes.CDLL(None).free(ctypes.c_void_p(pointer))
+    return compressed
+
+
+def test_inputs():
+    generator = random.Random(1)
+    inputs = []
+
+    for length in range(1, 17):
+        inputs.append(("random %d bytes" % length, bytes(generator.getrandbits(8) for _ in range(length))))
+    inputs.append(("every byte value", bytes(range(256))))
+    inputs.append(("high bytes", bytes(range(0x90, 0x100)) * 2))
+    inputs.append(("temperature", "<p>Temperature 25 °C</p>\n".encode()))
+    inputs.append(("arrow css", ('body { content: "→"; }\n' * 3).encode()))
+    inputs.append(("accent", ("a" * 48 + " é").encode()))
+    inputs.append(("random 100 KB", bytes(generator.getrandbits(8) for _ in range(100000))))
+    inputs.append(("text 200 KB", " ".join(generator.choice(["eva", "rover", "température", "°C", "→", "42.5"])
+                                           for _ in range(40000)).encode()))
+
+    for folder in ("frontend", "data"):
+        for name in sorted(os.listdir(os.path.join(ROOT, folder))):
+            path = os.path.join(ROOT, folder, name)
+            if os.path.isfile(path):
+                with open(path, "rb") as file:
+                    inputs.append((folder + "/" + name, file.read()))
+
+    return inputs
+
+
+def main():
+    with tempfile.TemporaryDirectory() as directory:
+        encoder = load_encoder(directory)
+
+        failures = 0
+        seen = set()
+        for name, data in test_inputs():
+            compressed = compress(encoder, data)
+            # First block header follows the 10 byte gzip header
+            block_type = BLOCK_TYPES[(compressed[10] >> 1) & 3]
+            seen.add(block_type)
+
+            try:
+                ok = gzip.decompress(compressed) == data
+            except Exception as error:
+                ok = False
+                print("%s: %s" % (name, error))
+
+            if not ok:
+                failures += 1
+            print("%-4s %-8s %8d -> %8d  %s" % ("ok" if ok else "FAIL", block_type, len(data), len(compressed), name))
+
+    for block_type in BLOCK_TYPES[:3]:
+        if block_type not in seen:
+            print("No input was written as a %s block" % block_type)
+            failures += 1
+
+    print("%d failures" % failures)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,6 +1,7 @@
 #include "data.h"
 #include "lib/simulation/throw_errors.h"
 
+#include <ctype.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -10,6 +11,39 @@
 bool oxy_error_flag = true;
 bool fan_error_flag = false;
 
+// Store used by the filename based helpers below (update_json_file, get_field_from_json, ...), owned by the backend
+static struct telemetry_store_t* telemetry_store = NULL;
+
+// Typed setter that writes a UDP POST payload (network byte order) to the field behind a handle
+typedef bool (*udp_post_setter_t)(store_handle_t handle, unsigned char* data, int data_length);
+
+struct udp_post_dispatch_t {
+    udp_post_setter_t setter;   // NULL for commands without a mapping
+    store_handle_t handle;
+};
+
+// UDP POST commands indexed directly by command id, built from udp_command_mappings at startup
+static struct udp_post_dispatch_t udp_post_dispatch[UDP_POST_COMMAND_MAX - UDP_POST_COMMAND_MIN + 1];
+
+// Source of one binary record field, resolved once at startup
+struct binary_field_source_t {
+    sim_field_t* field;         // simulation field the value is read from, NULL for values read from the store
+    store_handle_t handle;      // store item for values without a simulation field
+    int count;
+};
+
+// Binary record sources for each dataset in layout order
+static struct binary_field_source_t* binary_sources[STORE_DATASET_COUNT];
+static int binary_source_counts[STORE_DATASET_COUNT];
+
+static void build_udp_post_dispatch(void);
+static bool set_udp_float_array(store_handle_t handle, unsigned char* data, int data_length);
+static void build_binary_layouts(sim_engine_t* engine);
+static size_t encode_binary_record(struct telemetry_store_t* store, store_dataset_t dataset,
+                                   unsigned char* buffer, size_t capacity, void* context);
+static int bind_external_store_value(const char* file_path, const char* field_path);
+static bool read_external_store_value(int handle, float* value);
+
 ///////////////////////////////////////////////////////////////////////////////////
 //                        Backend Lifecycle Management
 ///////////////////////////////////////////////////////////////////////////////////
@@ -29,11 +63,22 @@ struct backend_data_t *init_backend() {
     backend->running_pr_sim = -1;
     backend->pr_sim_paused = false;
 
-    
+    // Load the telemetry datasets into memory, all reads and writes go through the store from here on
+    backend->store = store_create();
+    if (!backend->store) {
+        printf("Error: Failed to create telemetry store\n");
+        free(backend);
+        return NULL;
+    }
+    telemetry_store = backend->store;
+    build_udp_post_dispatch();
 
     // Initialize simulation engine
     backend->sim_engine = sim_engine_create();
     if (backend->sim_engine) {
+        // External values are read from the resident store instead of the data folder
+        backend->sim_engine->bind_external_value = bind_external_store_value;
+        backend->sim_engine->read_external_value = read_external_store_value;
 
         if (!sim_engine_load_predefined_configs(backend->sim_engine)) {
             printf("Warning: Failed to load simulation configurations\n");
@@ -46,6 +91,10 @@ struct backend_data_t *init_backend() {
         printf("Warning: Failed to create simulation engine\n");
     }
 
+    // Binary records are rebuilt with every snapshot from the simulation fields and the store
+    build_binary_layouts(backend->sim_engine);
+    store_set_binary_encoder(backend->store, encode_binary_record, NULL);
+
     
 
     printf("Backend and simulation engine initialized successfully\n");
@@ -82,7 +131,7 @@ void update_remaining_errors(sim_engine_t* engine) {
     }
 
     //count the number of values in the LTV json file under "errors" that are set to true to indicate that those errors are still being thrown, and update the number of task board errors accordingly
-    cJSON* ltv_config = get_json_file("LTV");
+    cJSON* ltv_config = store_get_root(telemetry_store, STORE_DATASET_LTV);
     if (!ltv_config) {
         printf("Error: Failed to load LTV config file in update_remaining_errors\n");
         return;
@@ -91,7 +140,6 @@ void update_remaining_errors(sim_engine_t* engine) {
     cJSON* errors = cJSON_GetObjectItem(ltv_config, "errors");
     if (!errors || !cJSON_IsObject(errors)) {
         printf("Error: Missing or invalid 'errors' object in LTV config file\n");
-        cJSON_Delete(ltv_config);
         return;
     }
 
@@ -109,8 +157,6 @@ void update_remaining_errors(sim_engine_t* engine) {
     if(remaining_errors !=0) {
         engine->time_to_complete_task_board += 1; //increment time to complete task board by 1 second, simulating the increased time to complete the task board with more errors
     }
-    cJSON_Delete(ltv_config);
-
 }
 
 /**
@@ -342,6 +388,7 @@ void increment_simulation(struct backend_data_t *backend) {
 
     // Update simulation engine once per second
     if (time_incremented) {
+        store_lock(backend->store);
 
         // Update simulation engine with elapsed time
         float delta_time = 1.0f;  // 1 second per update
@@ -353,6 +400,8 @@ void increment_simulation(struct backend_data_t *backend) {
         }
         // Update EVA station timing
         update_eva_station_timing();
+
+        store_unlock(backend->store);
     }
 }
 
@@ -364,11 +413,28 @@ void increment_simulation(struct backend_data_t *backend) {
 void cleanup_backend(struct backend_data_t *backend) {
     if (!backend) return;
 
+    // Stop the persistence thread, it writes out any pending changes before the telemetry store is released.
+    // The last snapshot still encodes the binary records from the simulation, so the engine is destroyed after.
+    if (backend->store) {
+        store_stop_flusher(backend->store);
+    }
+
     // Cleanup simulation engine
     if (backend->sim_engine) {
         sim_engine_destroy(backend->sim_engine);
     }
 
+    if (backend->store) {
+        store_destroy(backend->store);
+        telemetry_store = NULL;
+    }
+
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        free(binary_sources[i]);
+        binary_sources[i] = NULL;
+        binary_source_counts[i] = 0;
+    }
+
     // Free backend data structure
     free(backend);
 }
@@ -380,356 +446,449 @@ void cleanup_backend(struct backend_data_t *backend) {
 
 
 /**
- * Handles UDP GET requests for data retrieval
+ * Handles UDP GET requests for data retrieval. The response is sent by the caller straight from the
+ * current snapshot, so this only picks the dataset and its encoding.
  * 
  * @param command Command identifier for the GET request
- * @param data Response buffer to populate with requested data
+ * @param binary Set to true if the fixed-layout binary record was requested instead of JSON
  * @param backend Backend data structure containing all telemetry and simulation engines
+ * @return Dataset to send back, or -1 for an invalid command
+ */
+int handle_udp_get_request(unsigned int command, bool* binary, struct backend_data_t* backend) {
+    int dataset = udp_get_command_dataset(command, binary);
+
+    // Binary records are meant to be polled at a high rate, so only JSON requests are logged
+    if (dataset < 0) {
+        printf("Invalid GET command: %u\n", command);
+    } else if (!*binary) {
+        printf("Getting %s telemetry data.\n", backend->store->datasets[dataset].name);
+    }
+
+    return dataset;
+}
+
+/**
+ * Maps a UDP GET command to the dataset and encoding it returns, shared by GET requests and subscriptions
+ *
+ * @param command Command identifier for the GET request
+ * @param binary Set to true if the command returns the fixed-layout binary record instead of JSON
+ * @return Dataset of the command, or -1 for an invalid command
  */
-void handle_udp_get_request(unsigned int command, unsigned char* data, struct backend_data_t* backend) {
-    // Handle different GET requests
+int udp_get_command_dataset(unsigned int command, bool* binary) {
+    *binary = false;
+
     switch (command) {
         case 0: // ROVER telemetry
-            printf("Getting ROVER telemetry data.\n");
-            send_json_file("ROVER", data);
-            break;
+            return STORE_DATASET_ROVER;
         case 1: // EVA telemetry
-            printf("Getting EVA telemetry data.\n");
-            send_json_file("EVA", data);
-            break;
+            return STORE_DATASET_EVA;
         case 2: // LTV data
-            printf("Getting LTV telemetry data.\n");
-            send_json_file("LTV", data);
-            break;
-
+            return STORE_DATASET_LTV;
+
+        case UDP_GET_BINARY_ROVER:
+            *binary = true;
+            return STORE_DATASET_ROVER;
+        case UDP_GET_BINARY_EVA:
+            *binary = true;
+            return STORE_DATASET_EVA;
+        case UDP_GET_BINARY_LTV:
+            *binary = true;
+            return STORE_DATASET_LTV;
 
         default:
-            printf("Invalid GET command: %u\n", command);
-            break;
+            return -1;
     }
 }
 
 /**
- * Handles UDP POST requests for data updates using command-to-path mapping
+ * Handles UDP POST requests for data updates through the command dispatch table
  *
  * @param command Command identifier for the POST request
- * @param data Request buffer containing data to update
+ * @param data Request payload following the command, in network byte order
+ * @param data_length Size of the payload in bytes
  * @param backend Backend data structure containing all telemetry and simulation engines
  * 
  * @return true if the update was successful, false otherwise
  */
-bool handle_udp_post_request(unsigned int command, unsigned char* data, struct backend_data_t* backend) {
-    // Find the mapping for this command
-    const udp_command_mapping_t* mapping = NULL;
-    for (int i = 0; udp_command_mappings[i].path != NULL; i++) {
-        if (udp_command_mappings[i].command == command) {
-            mapping = &udp_command_mappings[i];
-            break;
-        }
+bool handle_udp_post_request(unsigned int command, unsigned char* data, int data_length, struct backend_data_t* backend) {
+    if (command < UDP_POST_COMMAND_MIN || command > UDP_POST_COMMAND_MAX ||
+        udp_post_dispatch[command - UDP_POST_COMMAND_MIN].setter == NULL) {
+        printf("Invalid UDP POST command: %u\n", command);
+        return false;
     }
 
-    if (!mapping) {
-        printf("Invalid UDP POST command: %u\n", command);
+    struct udp_post_dispatch_t* entry = &udp_post_dispatch[command - UDP_POST_COMMAND_MIN];
+    if (entry->handle == STORE_INVALID_HANDLE) {
         return false;
     }
-    
-    // Extract value from UDP data
-    char value_str[32];
-
-    if (mapping->data_type == "bool") {
-        // Special case for Unreal Engine commands where bool is sent as float
-        float bool_float;
-        memcpy(&bool_float, data, 4);
-        bool value = bool_float != 0.0f;
-        strcpy(value_str, value ? "true" : "false");
-    } else {
-        // Other commands extract float value from packet format
-        if (strcmp(mapping->data_type, "bool") == 0) {
-            bool value = extract_bool_value(data);
 
-            strcpy(value_str, value ? "true" : "false");
-        } else if (strcmp(mapping->data_type, "float") == 0) {
-            float value = extract_float_value(data);
-            sprintf(value_str, "%.6f", value);
+    // Write the typed value straight to the store
+    store_lock(backend->store);
+    bool result = entry->setter(entry->handle, data, data_length);
+    store_unlock(backend->store);
+
+    return result;
+}
+
+/**
+ * Handles a UDP batch POST, applying several POST commands as one store batch. The payload is a sequence of
+ * UDP_BATCH_POST_ENTRY_SIZE byte entries, a POST command (uint32) followed by its value (4 bytes), in network
+ * byte order. Every command is checked before anything is written, so either all values are applied or none.
+ *
+ * @param data Request payload following the command, in network byte order
+ * @param data_length Size of the payload in bytes
+ * @param backend Backend data structure containing all telemetry and simulation engines
+ * 
+ * @return true if every value was applied
+ */
+bool handle_udp_batch_post_request(unsigned char* data, int data_length, struct backend_data_t* backend) {
+    if (data_length < UDP_BATCH_POST_ENTRY_SIZE || data_length % UDP_BATCH_POST_ENTRY_SIZE != 0) {
+        printf("Invalid UDP batch POST length: %d\n", data_length);
+        return false;
+    }
+
+    int count = data_length / UDP_BATCH_POST_ENTRY_SIZE;
+    for (int i = 0; i < count; i++) {
+        unsigned char* entry_data = data + i * UDP_BATCH_POST_ENTRY_SIZE;
+        unsigned int command = ((unsigned int)entry_data[0] << 24) | ((unsigned int)entry_data[1] << 16) |
+                               ((unsigned int)entry_data[2] << 8) | (unsigned int)entry_data[3];
+
+        // Array values don't fit an entry, only single bool and float commands can be batched
+        if (command < UDP_POST_COMMAND_MIN || command > UDP_POST_COMMAND_MAX ||
+            udp_post_dispatch[command - UDP_POST_COMMAND_MIN].setter == NULL ||
+            udp_post_dispatch[command - UDP_POST_COMMAND_MIN].setter == set_udp_float_array ||
+            udp_post_dispatch[command - UDP_POST_COMMAND_MIN].handle == STORE_INVALID_HANDLE) {
+            printf("Invalid UDP batch POST command: %u\n", command);
+            return false;
         }
     }
 
-    // Create request content in the same format as HTML forms
-    char request_content[256];
-    sprintf(request_content, "%s=%s", mapping->path, value_str);
+    store_begin_batch(backend->store);
+    for (int i = 0; i < count; i++) {
+        unsigned char* entry_data = data + i * UDP_BATCH_POST_ENTRY_SIZE;
+        unsigned int command = ((unsigned int)entry_data[0] << 24) | ((unsigned int)entry_data[1] << 16) |
+                               ((unsigned int)entry_data[2] << 8) | (unsigned int)entry_data[3];
 
-    // Reuse existing html_form_json_update function for all the JSON and simulation logic
-    //printf("Processing UDP command %u: %s = %s\n", command, mapping->path, value_str);
+        struct udp_post_dispatch_t* entry = &udp_post_dispatch[command - UDP_POST_COMMAND_MIN];
+        entry->setter(entry->handle, entry_data + 4, 4);
+    }
+    store_end_batch(backend->store);
 
-    bool result = html_form_json_update(request_content, backend);
+    return true;
+}
 
-    return result;
+/**
+ * Converts a float received over UDP to the value stored in the JSON, rounded to the given number of
+ * decimals so the data files show the value that was sent rather than its float approximation
+ */
+static double udp_float_to_double(float value, double scale) {
+    return round((double)value * scale) / scale;
 }
 
-///////////////////////////////////////////////////////////////////////////////////
-//                              Data Management
-///////////////////////////////////////////////////////////////////////////////////
+/**
+ * Boolean setter, DUST and the peripherals send booleans as a float where non-zero is true
+ */
+static bool set_udp_bool(store_handle_t handle, unsigned char* data, int data_length) {
+    if (data_length < 4) return false;
+
+    store_handle_set_bool(telemetry_store, handle, extract_bool_value(data));
+    return true;
+}
 
 /**
- * Updates a field within the specified JSON file (supports both simple and nested field paths)
- * 
- * @param filename Name of the JSON file to update (e.g., "EVA")
- * @param section Section within the JSON file to update (e.g., "telemetry")
- * @param field_path Field path within the section to update (e.g., "batt_time_left" or "eva1.batt")
- * @param new_value New value to set for the specified field
+ * Float setter for single telemetry values
  */
-void update_json_file(const char* filename, const char* section, const char* field_path, char* new_value) {
-    // Construct the file path
-    char file_path[100];
-    snprintf(file_path, sizeof(file_path), "data/%s.json", filename);
-
-    // Read existing JSON file
-    FILE *fp = fopen(file_path, "r");
-    if (fp == NULL) {
-        printf("Error: Unable to open the file %s for reading.\n", file_path);
-        return;
+static bool set_udp_float(store_handle_t handle, unsigned char* data, int data_length) {
+    if (data_length < 4) return false;
+
+    store_handle_set_number(telemetry_store, handle, udp_float_to_double(extract_float_value(data), 1e6));
+    return true;
+}
+
+/**
+ * Float array setter, used for the LiDAR readings sent by DUST as LIDAR_NUM_POINTS consecutive floats
+ */
+static bool set_udp_float_array(store_handle_t handle, unsigned char* data, int data_length) {
+    if (data_length < LIDAR_NUM_POINTS * 4) return false;
+
+    double values[LIDAR_NUM_POINTS];
+    for (int i = 0; i < LIDAR_NUM_POINTS; i++) {
+        values[i] = udp_float_to_double(extract_float_value(data + i * 4), 1e2);
     }
 
-    fseek(fp, 0L, SEEK_END);
-    long file_size = ftell(fp);
-    rewind(fp);
+    store_set_number_array(telemetry_store, store_handle_dataset(telemetry_store, handle),
+                           store_handle_node(telemetry_store, handle), values, LIDAR_NUM_POINTS);
+    return true;
+}
 
-    char *file_buffer = malloc(file_size + 1);
-    fread(file_buffer, 1, file_size, fp);
-    file_buffer[file_size] = '\0'; // Null-terminate the buffer
-    fclose(fp);
+/**
+ * Builds the UDP POST dispatch table, resolving every command in udp_command_mappings to a store handle
+ * and a setter for its data type once at startup
+ */
+static void build_udp_post_dispatch(void) {
+    for (int i = 0; udp_command_mappings[i].path != NULL; i++) {
+        const udp_command_mapping_t* mapping = &udp_command_mappings[i];
+        if (mapping->command < UDP_POST_COMMAND_MIN || mapping->command > UDP_POST_COMMAND_MAX) {
+            printf("Warning: UDP command %u is outside the POST range\n", mapping->command);
+            continue;
+        }
 
-    // Parse the JSON content
-    cJSON *json = cJSON_Parse(file_buffer);
-    free(file_buffer);
+        struct udp_post_dispatch_t* entry = &udp_post_dispatch[mapping->command - UDP_POST_COMMAND_MIN];
+        if (strcmp(mapping->data_type, "bool") == 0) {
+            entry->setter = set_udp_bool;
+        } else if (strcmp(mapping->data_type, "float") == 0) {
+            entry->setter = set_udp_float;
+        } else if (strcmp(mapping->data_type, "array<float>") == 0) {
+            entry->setter = set_udp_float_array;
+        } else {
+            printf("Warning: Unknown data type %s for UDP command %u\n", mapping->data_type, mapping->command);
+            continue;
+        }
 
-    if (json == NULL) {
-        printf("Error: Failed to parse JSON from file %s., check data folder for existing files. Accidental edits to those files can be resolved with git checkout data\n", file_path);
-        return;
+        entry->handle = store_resolve_route(telemetry_store, mapping->path);
+        if (entry->handle == STORE_INVALID_HANDLE) {
+            printf("Warning: UDP command %u maps to missing field %s\n", mapping->command, mapping->path);
+        }
     }
+}
 
-    // Navigate to the specified section
-    cJSON *section_json = cJSON_GetObjectItemCaseSensitive(json, section);
-    if (section_json == NULL) {
-        printf("Error: Section %s not found in JSON.\n", section);
-        cJSON_Delete(json);
-        return;
+/**
+ * Finds the simulation field behind a binary record path, following the same component mapping as
+ * sync_simulation_to_store (EVA "telemetry.<component>.<field>" and ROVER "pr_telemetry.<field>").
+ * Returns NULL for paths the simulation does not produce.
+ */
+static sim_field_t* find_binary_sim_field(sim_engine_t* engine, store_dataset_t dataset, const char* path) {
+    if (!engine) return NULL;
+
+    char component_name[64];
+    const char* field_name = NULL;
+    if (dataset == STORE_DATASET_EVA && strncmp(path, "telemetry.", 10) == 0) {
+        const char* component_start = path + 10;
+        const char* dot = strchr(component_start, '.');
+        if (!dot || (size_t)(dot - component_start) >= sizeof(component_name)) return NULL;
+
+        memcpy(component_name, component_start, dot - component_start);
+        component_name[dot - component_start] = '\0';
+        field_name = dot + 1;
+    } else if (dataset == STORE_DATASET_ROVER && strncmp(path, "pr_telemetry.", 13) == 0) {
+        strcpy(component_name, "rover");
+        field_name = path + 13;
+    } else {
+        return NULL;
     }
 
-    // Parse the field path and navigate through it (supports both simple and nested paths)
-    char field_path_copy[256];
-    strncpy(field_path_copy, field_path, sizeof(field_path_copy) - 1);
-    field_path_copy[sizeof(field_path_copy) - 1] = '\0';
-    
-    cJSON *current_object = section_json;
-    char* field_parts[10];
-    int field_part_count = 0;
-    
-    // Split field path by dots
-    char* token = strtok(field_path_copy, ".");
-    while (token != NULL && field_part_count < 10) {
-        field_parts[field_part_count++] = token;
-        token = strtok(NULL, ".");
-    }
-    
-    // Navigate through all but the last field part
-    for (int i = 0; i < field_part_count - 1; i++) {
-        cJSON *next_object = cJSON_GetObjectItemCaseSensitive(current_object, field_parts[i]);
-        if (next_object == NULL) {
-            printf("Error: Field path %s not found at level %s.\n", field_path, field_parts[i]);
-            cJSON_Delete(json);
-            return;
-        }
-        current_object = next_object;
+    sim_component_t* component = sim_engine_get_component(engine, component_name);
+    sim_field_t* field = component ? sim_engine_find_field_within_component(component, field_name) : NULL;
+
+    // External values are inputs owned by the store, the simulation only sees them while the component runs
+    if (field && field->starting_algorithm == SIM_ALGO_EXTERNAL_VALUE) {
+        return NULL;
     }
-    
-    // Update the final field
-    const char* final_field = field_parts[field_part_count - 1];
-    
-    // Determine value type and create appropriate JSON value
-    cJSON* new_json_value = NULL;
-    if (strcmp(new_value, "true") == 0) {
-        new_json_value = cJSON_CreateTrue();
-    } else if (strcmp(new_value, "false") == 0) {
-        new_json_value = cJSON_CreateFalse();
-    } else if (new_value[0] == '[') { // check if starts with bracket `[` for array (LiDAR)
-        // Parse as array of floats
-        cJSON* array = cJSON_CreateArray();
-        char* value_copy = strdup(new_value);
-        char* item = strtok(value_copy + 1, ",]");
-        
-        while (item != NULL) {
-            double num = strtod(item, NULL);
-            cJSON_AddItemToArray(array, cJSON_CreateNumber(num));
-            item = strtok(NULL, ",]");
+    return field;
+}
+
+/**
+ * Resolves every field of the binary record layouts to a simulation field or a store handle once at startup
+ */
+static void build_binary_layouts(sim_engine_t* engine) {
+    const binary_telemetry_field_t* layouts[STORE_DATASET_COUNT] = {0};
+    layouts[STORE_DATASET_EVA] = binary_eva_layout;
+    layouts[STORE_DATASET_ROVER] = binary_rover_layout;
+    layouts[STORE_DATASET_LTV] = binary_ltv_layout;
+
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        int field_count = 0;
+        while (layouts[i][field_count].path != NULL) {
+            field_count++;
         }
 
-        free(value_copy);
-        new_json_value = array;
-    } else {
-        // Try to parse as number
-        char* endptr;
-        double num_value = strtod(new_value, &endptr);
-        if (*endptr == '\0') {
-            // It's a valid number
-            new_json_value = cJSON_CreateNumber(num_value);
-        } else {
-            // Treat as string
-            new_json_value = cJSON_CreateString(new_value);
+        binary_sources[i] = calloc(field_count, sizeof(struct binary_field_source_t));
+        if (!binary_sources[i]) {
+            printf("Error: Failed to allocate binary layout for dataset %d\n", i);
+            continue;
         }
-    }
-    
-    cJSON_ReplaceItemInObject(current_object, final_field, new_json_value);
+        binary_source_counts[i] = field_count;
 
-    // Write updated JSON back to file
-    char *json_str = cJSON_Print(json);
-    if (json_str == NULL) {
-        printf("Error: Failed to print JSON to string.\n");
-        cJSON_Delete(json);
-        return;
-    }
+        for (int j = 0; j < field_count; j++) {
+            const binary_telemetry_field_t* layout_field = &layouts[i][j];
+            struct binary_field_source_t* source = &binary_sources[i][j];
+            const char* path = strchr(layout_field->path, '.') + 1;
 
-    fp = fopen(file_path, "w");
-    if (fp == NULL) {
-        printf("Error: Unable to open the file %s for writing.\n", file_path);
-        free(json_str);
-        cJSON_Delete(json);
-        return;
+            source->count = layout_field->count;
+            source->field = layout_field->count == 1 ? find_binary_sim_field(engine, i, path) : NULL;
+            source->handle = source->field ? STORE_INVALID_HANDLE : store_resolve(telemetry_store, i, path);
+
+            if (!source->field && source->handle == STORE_INVALID_HANDLE) {
+                printf("Warning: Binary record field %s does not exist and is sent as NaN\n", layout_field->path);
+            }
+        }
     }
+}
 
-    fputs(json_str, fp);
-    fclose(fp);
+/**
+ * Writes a 32-bit value in network byte order
+ */
+static unsigned char* write_binary_uint32(unsigned char* buffer, uint32_t value) {
+    buffer[0] = (value >> 24) & 0xFF;
+    buffer[1] = (value >> 16) & 0xFF;
+    buffer[2] = (value >> 8) & 0xFF;
+    buffer[3] = value & 0xFF;
+    return buffer + 4;
+}
 
-    free(json_str);
-    cJSON_Delete(json);
+static unsigned char* write_binary_float(unsigned char* buffer, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return write_binary_uint32(buffer, bits);
 }
 
 /**
- * Loads and returns a cJSON object from the specified JSON file
+ * Encodes the binary record of a dataset, called by the store with its lock held whenever a snapshot is built.
+ * Layout (big-endian): schema version u32, dataset version u32, value count u32, then value count float32s.
  *
- * @param filename Name of the JSON file to load (e.g., "EVA")
- * @return Pointer to the cJSON object representing the file content, or NULL on failure
+ * @return Length of the record, or 0 if it does not fit in the buffer
  */
-cJSON* get_json_file(const char* filename) {
-    // Construct the file path
-    char file_path[100];
-    snprintf(file_path, sizeof(file_path), "data/%s.json", filename);
-
-    // Read existing JSON file
-    FILE *fp = fopen(file_path, "r");
-    if (fp == NULL) {
-        printf("Error: Unable to open the file %s for reading.\n", file_path);
-        return NULL;
+static size_t encode_binary_record(struct telemetry_store_t* store, store_dataset_t dataset,
+                                   unsigned char* buffer, size_t capacity, void* context) {
+    (void)context; // the layouts are the file's binary_sources, registered without a context
+
+    int value_count = 0;
+    for (int i = 0; i < binary_source_counts[dataset]; i++) {
+        value_count += binary_sources[dataset][i].count;
     }
 
-    fseek(fp, 0L, SEEK_END);
-    long file_size = ftell(fp);
-    rewind(fp);
+    size_t length = BINARY_TELEMETRY_HEADER_SIZE + (size_t)value_count * 4;
+    if (length > capacity) {
+        printf("Error: Binary record for %s does not fit in %lu bytes\n", store->datasets[dataset].name,
+               (unsigned long)capacity);
+        return 0;
+    }
 
-    char *file_buffer = malloc(file_size + 1);
-    fread(file_buffer, 1, file_size, fp);
-    file_buffer[file_size] = '\0'; // Null-terminate the buffer
-    fclose(fp);
+    unsigned char* out = buffer;
+    out = write_binary_uint32(out, BINARY_TELEMETRY_SCHEMA_VERSION);
+    out = write_binary_uint32(out, (uint32_t)store->datasets[dataset].version);
+    out = write_binary_uint32(out, (uint32_t)value_count);
 
-    // Parse the JSON content
-    cJSON *json = cJSON_Parse(file_buffer);
-    free(file_buffer);
+    for (int i = 0; i < binary_source_counts[dataset]; i++) {
+        struct binary_field_source_t* source = &binary_sources[dataset][i];
 
-    if (json == NULL) {
-        printf("Error: Failed to parse JSON from file %s., check data folder for existing files. Accidental edits to those files can be resolved with git checkout data\n", file_path);
-        return NULL;
+        if (source->field) {
+            out = write_binary_float(out, source->field->current_value.f);
+        } else if (source->count == 1) {
+            double value = NAN;
+            store_handle_get_number(store, source->handle, &value);
+            out = write_binary_float(out, (float)value);
+        } else {
+            // Arrays are padded with NaN when they hold fewer values than the layout expects
+            cJSON* node = store_handle_node(store, source->handle);
+            cJSON* item = cJSON_IsArray(node) ? node->child : NULL;
+            for (int j = 0; j < source->count; j++) {
+                float value = cJSON_IsNumber(item) ? (float)item->valuedouble : NAN;
+                out = write_binary_float(out, value);
+                item = item ? item->next : NULL;
+            }
+        }
     }
 
-    return json;
+    return length;
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+//                              Data Management
+///////////////////////////////////////////////////////////////////////////////////
+
 /**
- * Sends the entire JSON file content as response data
- *
- * @param filename Name of the JSON file (e.g., "EVA")
- * @param data Response buffer to populate with JSON string
+ * Updates a field within the specified dataset (supports both simple and nested field paths).
+ * The change is applied to the resident telemetry store and persisted to the data folder later.
+ * 
+ * @param filename Name of the JSON file to update (e.g., "EVA")
+ * @param section Section within the JSON file to update (e.g., "telemetry")
+ * @param field_path Field path within the section to update (e.g., "batt_time_left" or "eva1.batt")
+ * @param new_value New value to set for the specified field
  */
-void send_json_file(const char* filename, unsigned char* data) {
-    cJSON* json = get_json_file(filename);
-    if (json == NULL) {
-        printf("Error: Could not load JSON file %s\n", filename);
+void update_json_file(const char* filename, const char* section, const char* field_path, char* new_value) {
+    int dataset = store_dataset_from_name(filename);
+    if (dataset < 0) {
+        printf("Error: Unknown data file %s.\n", filename);
         return;
     }
-    
-    // Convert JSON to string
-    char* json_str = cJSON_Print(json);
-    if (json_str == NULL) {
-        printf("Error: Failed to convert JSON to string\n");
-        cJSON_Delete(json);
+
+    // Resolve section and field path (supports both simple and nested paths) as one dataset path
+    char path[256];
+    snprintf(path, sizeof(path), "%s.%s", section, field_path);
+
+    store_handle_t handle = store_resolve(telemetry_store, dataset, path);
+    if (handle == STORE_INVALID_HANDLE) {
+        printf("Error: Field path %s not found in section %s.\n", field_path, section);
         return;
     }
-    
-    // Copy JSON string to response data buffer
-    size_t json_len = strlen(json_str);
-    memcpy(data, json_str, json_len);
-    data[json_len] = '\0'; // Null terminate
-    
-    // Cleanup
-    free(json_str);
-    cJSON_Delete(json);
-}
 
+    // Update the value in place, the store figures out the type from the string
+    store_lock(telemetry_store);
+    store_handle_set_from_string(telemetry_store, handle, new_value);
+    store_unlock(telemetry_store);
+}
 
 /**
- * Synchronizes the simulation engine data to the corresponding JSON files
+ * Returns a copy of the specified dataset from the resident telemetry store
  *
- * @param backend Backend data structure containing telemetry and simulation engine
+ * @param filename Name of the JSON file to load (e.g., "EVA")
+ * @return Pointer to a cJSON copy of the file content that the caller must free, or NULL on failure
  */
-void sync_simulation_to_json(struct backend_data_t* backend) {
-    sim_engine_t* engine = backend->sim_engine;
+cJSON* get_json_file(const char* filename) {
+    int dataset = store_dataset_from_name(filename);
+    cJSON* root = store_get_root(telemetry_store, dataset);
+    if (root == NULL) {
+        printf("Error: Unknown data file %s.\n", filename);
+        return NULL;
+    }
 
-    if (engine == NULL) {
-        printf("Error: Simulation engine is NULL.\n");
-        return;
+    store_lock(telemetry_store);
+    cJSON* copy = cJSON_Duplicate(root, true);
+    store_unlock(telemetry_store);
+
+    return copy;
+}
+
+/**
+ * Sets a numeric field inside a section, adding the field if it does not exist yet
+ */
+static void sync_number_field(store_dataset_t dataset, cJSON* section, const char* name, double value) {
+    cJSON* existing_field = cJSON_GetObjectItemCaseSensitive(section, name);
+    if (existing_field != NULL) {
+        store_set_number(telemetry_store, dataset, existing_field, value);
+    } else {
+        store_add_number(telemetry_store, dataset, section, name, value);
     }
+}
 
-    // Load EVA JSON file
-    cJSON* root = get_json_file("EVA");
+/**
+ * Copies the current simulation values into the store, the caller holds the store lock
+ */
+static void sync_simulation_to_store(sim_engine_t* engine, struct telemetry_store_t* store) {
+    // EVA dataset
+    cJSON* root = store_get_root(store, STORE_DATASET_EVA);
     if (root == NULL) {
         printf("Error: Could not load EVA.json\n");
         return;
     }
     
     // Get or create the status section and update existing started field
-    cJSON* status = cJSON_GetObjectItemCaseSensitive(root, "status");
-    if (status == NULL) {
-        status = cJSON_CreateObject();
-        cJSON_AddItemToObject(root, "status", status);
-    }
+    cJSON* status = store_get_or_add_object(store, STORE_DATASET_EVA, root, "status");
 
     // Update existing started field (check if eva1 OR eva2 is running)
     bool eva_running = sim_engine_is_component_running(engine, "eva1") || sim_engine_is_component_running(engine, "eva2");
     cJSON* started_field = cJSON_GetObjectItemCaseSensitive(status, "started");
     if (started_field != NULL) {
-        cJSON_SetBoolValue(started_field, eva_running);
+        store_set_bool(store, STORE_DATASET_EVA, started_field, eva_running);
     } else {
         cJSON_AddBoolToObject(status, "started", eva_running);
     }
 
-    // Get or create the telemetry section
-    cJSON* telemetry = cJSON_GetObjectItemCaseSensitive(root, "telemetry");
-    if (telemetry == NULL) {
-        telemetry = cJSON_CreateObject();
-        cJSON_AddItemToObject(root, "telemetry", telemetry);
-    }
-    
-    // Get or create eva1 and eva2 sections under telemetry
-    cJSON* eva1_section = cJSON_GetObjectItemCaseSensitive(telemetry, "eva1");
-    if (eva1_section == NULL) {
-        eva1_section = cJSON_CreateObject();
-        cJSON_AddItemToObject(telemetry, "eva1", eva1_section);
-    }
-    
-    cJSON* eva2_section = cJSON_GetObjectItemCaseSensitive(telemetry, "eva2");
-    if (eva2_section == NULL) {
-        eva2_section = cJSON_CreateObject();
-        cJSON_AddItemToObject(telemetry, "eva2", eva2_section);
-    }
+    // Get or create the telemetry section with eva1 and eva2 sections under it
+    cJSON* telemetry = store_get_or_add_object(store, STORE_DATASET_EVA, root, "telemetry");
+    cJSON* eva1_section = store_get_or_add_object(store, STORE_DATASET_EVA, telemetry, "eva1");
+    cJSON* eva2_section = store_get_or_add_object(store, STORE_DATASET_EVA, telemetry, "eva2");
     
     // Update simulation fields in their respective sections
     for (int i = 0; i < engine->total_field_count; i++) {
@@ -746,50 +905,26 @@ void sync_simulation_to_json(struct backend_data_t* backend) {
             }
     
             if (target_section != NULL) {
-                // Check if field already exists and replace it, otherwise add new
-                cJSON* existing_field = cJSON_GetObjectItemCaseSensitive(target_section, field->field_name);
-                if (existing_field != NULL) {
-                    cJSON_SetNumberValue(existing_field, value);
-                } else {
-                    cJSON_AddNumberToObject(target_section, field->field_name, value);
-                }
+                sync_number_field(STORE_DATASET_EVA, target_section, field->field_name, value);
             }
         }
     }
     
-    // Write EVA file
-    char filepath[100];
-    snprintf(filepath, sizeof(filepath), "data/EVA.json");
-    
-    char* json_str = cJSON_Print(root);
-    FILE* fp = fopen(filepath, "w");
-    if (fp) {
-        fputs(json_str, fp);
-        fclose(fp);
-    }
-    
-    free(json_str);
-    cJSON_Delete(root);
-    
-    // Now sync rover data to ROVER.json
-    cJSON* rover_root = get_json_file("ROVER");
+    // Now sync rover data to the ROVER dataset
+    cJSON* rover_root = store_get_root(store, STORE_DATASET_ROVER);
     if (rover_root == NULL) {
         printf("Error: Could not load ROVER.json\n");
         return;
     }
     
     // Get or create the pr_telemetry section
-    cJSON* pr_telemetry = cJSON_GetObjectItemCaseSensitive(rover_root, "pr_telemetry");
-    if (pr_telemetry == NULL) {
-        pr_telemetry = cJSON_CreateObject();
-        cJSON_AddItemToObject(rover_root, "pr_telemetry", pr_telemetry);
-    }
+    cJSON* pr_telemetry = store_get_or_add_object(store, STORE_DATASET_ROVER, rover_root, "pr_telemetry");
 
     // Update simulation running status in pr_telemetry (check if rover is running)
     bool rover_running = sim_engine_is_component_running(engine, "rover");
     cJSON* rover_sim_running_field = cJSON_GetObjectItemCaseSensitive(pr_telemetry, "sim_running");
     if (rover_sim_running_field != NULL) {
-        cJSON_SetBoolValue(rover_sim_running_field, rover_running);
+        store_set_bool(store, STORE_DATASET_ROVER, rover_sim_running_field, rover_running);
     } else {
         cJSON_AddBoolToObject(pr_telemetry, "sim_running", rover_running);
     }
@@ -803,181 +938,271 @@ void sync_simulation_to_json(struct backend_data_t* backend) {
                 continue;
             }
 
-            double value = field->current_value.f;
+            sync_number_field(STORE_DATASET_ROVER, pr_telemetry, field->field_name, field->current_value.f);
+        }
+    }
+}
+
+/**
+ * Synchronizes the simulation engine data to the corresponding datasets in the telemetry store
+ * and publishes a new snapshot for readers
+ *
+ * @param backend Backend data structure containing telemetry and simulation engine
+ */
+void sync_simulation_to_json(struct backend_data_t* backend) {
+    if (backend->sim_engine == NULL) {
+        printf("Error: Simulation engine is NULL.\n");
+        return;
+    }
+
+    store_lock(backend->store);
+    sync_simulation_to_store(backend->sim_engine, backend->store);
+
+    // Publish everything changed since the last tick, including updates received from clients
+    store_publish_snapshot(backend->store);
+    store_unlock(backend->store);
+}
+
+// Field write parsed from a route such as "eva.error.fan_error", every write of a batch is resolved before
+// any of them is applied
+struct route_update_t {
+    const char* route;           // dataset name followed by the field path inside it
+    const char* value;           // new value as text, see store_set_from_string
+    store_dataset_t dataset;
+    const char* path;            // path inside the dataset, points into route
+    store_handle_t handle;
+};
+
+/**
+ * Checks that a route names an existing field and resolves it to a handle.
+ *
+ * @param update Update with route and value set, the dataset, path, and handle are filled in
+ * @return true if the field exists
+ */
+static bool resolve_route_update(struct route_update_t* update) {
+    const char* route = update->route;
+
+    // The first part of the route selects the dataset, the rest is the path inside it (section.field or deeper)
+    const char* path = strchr(route, '.');
+    if (path == NULL) {
+        printf("Error: Route must have at least 2 parts (file.section): %s\n", route);
+        return false;
+    }
+    path++;
+
+    int dataset = store_dataset_from_name(route);
+    if (dataset < 0) {
+        printf("Error: Unsupported file type '%.*s'. Use 'eva', 'rover', or 'ltv'\n", (int)(path - route - 1), route);
+        return false;
+    }
+
+    if (strchr(path, '.') == NULL) {
+        printf("Error: Invalid route format: %s\n", route);
+        return false;
+    }
+
+    store_handle_t handle = store_resolve(telemetry_store, dataset, path);
+    if (handle == STORE_INVALID_HANDLE) {
+        printf("Error: Field path %s not found in %s.\n", path, telemetry_store->datasets[dataset].name);
+        return false;
+    }
+
+    update->dataset = dataset;
+    update->path = path;
+    update->handle = handle;
+    return true;
+}
+
+/**
+ * Writes a resolved update. Starting or stopping the EVA or rover simulation through its status field also
+ * starts or resets the simulation.
+ */
+static void apply_route_update(const struct route_update_t* update, struct backend_data_t* backend) {
+    const char* path = update->path;
+    const char* value = update->value;
+
+    // Update the value in place through the path's handle
+    store_handle_set_from_string(telemetry_store, update->handle, value);
+
+    // Handle simulation control for specific fields
+    if (backend->sim_engine) {
+        if (update->dataset == STORE_DATASET_ROVER && strcmp(path, "pr_telemetry.sim_running") == 0) {
+            if (strcmp(value, "true") == 0) {
+                sim_engine_start_component(backend->sim_engine, "rover");
+                printf("Started rover simulation\n");
+            } else {
+                sim_engine_reset_component(backend->sim_engine, "rover", update_json_file);
+                printf("Reset rover simulation\n");
+            }
+        }
 
-            // Check if field already exists and replace it, otherwise add new
-            cJSON* existing_field = cJSON_GetObjectItemCaseSensitive(pr_telemetry, field->field_name);
-            if (existing_field != NULL) {
-                cJSON_SetNumberValue(existing_field, value);
+        if (update->dataset == STORE_DATASET_EVA && strcmp(path, "status.started") == 0) {
+            if (strcmp(value, "true") == 0) {
+                sim_engine_start_component(backend->sim_engine, "eva1");
+                sim_engine_start_component(backend->sim_engine, "eva2");
+                printf("Started EVA simulation\n");
             } else {
-                cJSON_AddNumberToObject(pr_telemetry, field->field_name, value);
+                sim_engine_reset_component(backend->sim_engine, "eva1", update_json_file);
+                sim_engine_reset_component(backend->sim_engine, "eva2", update_json_file);
+                reset_eva_station_timing();
+                printf("Reset EVA simulation\n");
             }
         }
     }
-    
-    // Write ROVER file
-    snprintf(filepath, sizeof(filepath), "data/ROVER.json");
-    
-    char* rover_json_str = cJSON_Print(rover_root);
-    FILE* rover_fp = fopen(filepath, "w");
-    if (rover_fp) {
-        fputs(rover_json_str, rover_fp);
-        fclose(rover_fp);
+}
+
+/**
+ * Applies a group of updates as one store batch. Nothing is written unless every route is valid, and readers
+ * see either none or all of the new values with a single version bump per changed dataset.
+ *
+ * @param updates Updates with route and value set
+ * @param count Number of updates
+ * @param backend Backend data structure
+ * @return true if every update was applied
+ */
+static bool apply_route_updates(struct route_update_t* updates, int count, struct backend_data_t* backend) {
+    if (count == 0) {
+        printf("Error: Update request without any route\n");
+        return false;
     }
-    
-    free(rover_json_str);
-    cJSON_Delete(rover_root);
+
+    store_begin_batch(telemetry_store);
+
+    for (int i = 0; i < count; i++) {
+        if (!resolve_route_update(&updates[i])) {
+            store_end_batch(telemetry_store);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        apply_route_update(&updates[i], backend);
+    }
+
+    store_end_batch(telemetry_store);
+    return true;
 }
 
 /**
- * Updates a field in a JSON file based on a route-style request (for example, "eva.error.fan_error=true") from a HTML form submission
- * The request content is parsed and matched to the appropriate JSON file and field.
- * 
- * // @TODO look into this more
+ * Decodes a URL-encoded form component in place, "+" becomes a space and "%XX" the byte it encodes.
+ */
+static void url_decode(char* text) {
+    char* out = text;
+    for (char* in = text; *in; in++) {
+        if (*in == '+') {
+            *out++ = ' ';
+        } else if (in[0] == '%' && isxdigit((unsigned char)in[1]) && isxdigit((unsigned char)in[2])) {
+            char hex[3] = {in[1], in[2], 0};
+            *out++ = (char)strtol(hex, NULL, 16);
+            in += 2;
+        } else {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+}
+
+/**
+ * Updates fields in the JSON files based on route-style requests (for example, "eva.error.fan_error=true") from a HTML form submission
+ * The request content is parsed and matched to the appropriate JSON file and field. Several "route=value" pairs
+ * separated by "&" are applied together, e.g. to flip every UIA switch at once.
  * 
  * @example request_content: "eva.error.fan_error=true" -> EVA.json, section "error", field "fan_error", value true
- * @param request_content String containing the route-based update request
+ * @param request_content String containing the route-based update request, decoded in place
  * @param backend Backend data structure
  * @return true if update was successful, false otherwise
  */
 bool html_form_json_update(char* request_content, struct backend_data_t* backend) {
-    // Parse URL-encoded data: "route=value"
-    char* route = NULL;
-    char* value = NULL;
-
-    // Create a copy to work with since strtok modifies the string
-    char request_copy[1024];
-    strncpy(request_copy, request_content, sizeof(request_copy) - 1);
-    request_copy[sizeof(request_copy) - 1] = '\0';
-
-    // Parse URL-encoded parameters
-    char* param = strtok(request_copy, "&");
-    while (param != NULL) {
-        char* equals_pos = strchr(param, '=');
-        if (equals_pos != NULL) {
-            *equals_pos = '\0';  // Split parameter name and value
-            char* param_name = param;
-            char* param_value = equals_pos + 1;
-
-            // route parameter e.g. "eva.error.fan_error"
-            route = param_name;
-            value = param_value;
-            break;  // Take the first parameter as the route
-        }
-        param = strtok(NULL, "&");
+    int capacity = 1;
+    for (const char* c = request_content; *c; c++) {
+        if (*c == '&') capacity++;
     }
 
-    if (route == NULL || value == NULL) {
-        printf("Error: Invalid format, missing route or value in request: %s\n", request_content);
+    struct route_update_t* updates = calloc(capacity, sizeof(struct route_update_t));
+    if (!updates) {
         return false;
     }
 
-    // Parse the route (split by dots)
-    char route_copy[256];
-    strncpy(route_copy, route, sizeof(route_copy) - 1);
-    route_copy[sizeof(route_copy) - 1] = '\0';
-    
-    // Split route into parts
-    char* route_parts[10];  // Support up to 10 levels deep
-    int part_count = 0;
-    
-    char* token = strtok(route_copy, ".");
-    while (token != NULL && part_count < 10) {
-        route_parts[part_count++] = token;
-        token = strtok(NULL, ".");
+    // Parse URL-encoded data: "route=value&route=value"
+    int count = 0;
+    char* save = NULL;
+    for (char* pair = strtok_r(request_content, "&", &save); pair; pair = strtok_r(NULL, "&", &save)) {
+        char* equals_pos = strchr(pair, '=');
+        if (equals_pos == NULL || equals_pos == pair) {
+            printf("Error: Invalid format, missing route or value in request: %s\n", pair);
+            free(updates);
+            return false;
+        }
+
+        *equals_pos = '\0';
+        url_decode(pair);
+        url_decode(equals_pos + 1);
+        updates[count].route = pair;
+        updates[count].value = equals_pos + 1;
+        count++;
     }
-    
-    if (part_count < 2) {
-        printf("Error: Route must have at least 2 parts (file.section): %s\n", route);
+
+    bool result = apply_route_updates(updates, count, backend);
+    free(updates);
+    return result;
+}
+
+/**
+ * Applies every update in a JSON object that maps routes to values as one batch, so a dashboard can push many
+ * fields with one request. Booleans, numbers, arrays of numbers, and strings are written like the form values.
+ *
+ * @example request_content: {"eva.error.fan_error": true, "rover.pr_telemetry.brakes": 1}
+ * @param request_content JSON object sent as the request body
+ * @param backend Backend data structure
+ * @return true if the body is a JSON object and every route in it is valid
+ */
+bool html_json_batch_update(const char* request_content, struct backend_data_t* backend) {
+    cJSON* body = cJSON_Parse(request_content);
+    if (!cJSON_IsObject(body)) {
+        printf("Error: JSON update must be an object of route and value pairs\n");
+        cJSON_Delete(body);
         return false;
     }
-    
-    // Determine file type and construct JSON path
-    const char* filename = NULL;
-    if (strcmp(route_parts[0], "eva") == 0) {
-        filename = "EVA";
-    } else if (strcmp(route_parts[0], "rover") == 0) {
-        filename = "ROVER";
-    } else if (strcmp(route_parts[0], "ltv") == 0) {
-        filename = "LTV";
-    } else {
-        printf("Error: Unsupported file type '%s'. Use 'eva', 'rover', or 'ltv'\n", route_parts[0]);
+
+    int capacity = cJSON_GetArraySize(body);
+    struct route_update_t* updates = calloc(capacity ? capacity : 1, sizeof(struct route_update_t));
+    if (!updates) {
+        cJSON_Delete(body);
         return false;
     }
-    
-    // Build the JSON path from remaining route parts
-
-    if (part_count == 3) {
-        // Simple case: file.section.field
-        const char* section = route_parts[1];
-        const char* field = route_parts[2];
-        
-        update_json_file(filename, section, field, value);
-
-        // Handle simulation control for specific fields
-        if (strcmp(filename, "ROVER") == 0 && strcmp(section, "pr_telemetry") == 0 && strcmp(field, "sim_running") == 0) {
-            if (backend->sim_engine) {
-                if (strcmp(value, "true") == 0) {
-                    sim_engine_start_component(backend->sim_engine, "rover");
-                    printf("Started rover simulation\n");
-                } else {
-                    sim_engine_reset_component(backend->sim_engine, "rover", update_json_file);
-                    printf("Reset rover simulation\n");
-                }
-            }
-        }
 
-        if (strcmp(filename, "EVA") == 0 && strcmp(section, "status") == 0 && strcmp(field, "started") == 0) {
-            if (backend->sim_engine) {
-                if (strcmp(value, "true") == 0) {
-                    sim_engine_start_component(backend->sim_engine, "eva1");
-                    sim_engine_start_component(backend->sim_engine, "eva2");
-                    printf("Started EVA simulation\n");
-                } else {
-                    sim_engine_reset_component(backend->sim_engine, "eva1", update_json_file);
-                    sim_engine_reset_component(backend->sim_engine, "eva2", update_json_file);
-                    reset_eva_station_timing();
-                    printf("Reset EVA simulation\n");
-                }
-            }
+    bool result = true;
+    int count = 0;
+    cJSON* item = NULL;
+    cJSON_ArrayForEach(item, body) {
+        // Values go through the same text form as a form submission, e.g. true, 1.5, or [1,2]
+        char* value = NULL;
+        if (cJSON_IsString(item)) {
+            value = strdup(item->valuestring);
+        } else if (cJSON_IsBool(item) || cJSON_IsNumber(item) || cJSON_IsArray(item)) {
+            value = cJSON_PrintUnformatted(item);
         }
 
-        return true;
-    } else if (part_count > 3) {
-        // Nested case: file.section.subsection.field or deeper
-        const char* section = route_parts[1];
-        
-        // Rebuild the nested field path from remaining parts
-        char nested_field[256] = "";
-        for (int i = 2; i < part_count; i++) {
-            if (i > 2) {
-                strcat(nested_field, ".");
-            }
-            strcat(nested_field, route_parts[i]);
-        }
-        
-        // For now, handle nested updates by directly updating the JSON
-        // This requires extending update_json_file to handle nested paths
-        update_json_file(filename, section, nested_field, value);
-
-        // Handle simulation control for specific nested fields
-        if (strcmp(filename, "ROVER") == 0 && strcmp(section, "pr_telemetry") == 0 && strcmp(nested_field, "sim_running") == 0) {
-            if (backend->sim_engine) {
-                if (strcmp(value, "true") == 0) {
-                    sim_engine_start_component(backend->sim_engine, "rover");
-                    printf("Started rover simulation\n");
-                } else {
-                    sim_engine_reset_component(backend->sim_engine, "rover", update_json_file);
-                    printf("Reset rover simulation\n");
-                }
-            }
+        if (value == NULL) {
+            printf("Error: Invalid update for route %s\n", item->string);
+            result = false;
+            break;
         }
+        updates[count].route = item->string;
+        updates[count].value = value;
+        count++;
+    }
 
-        return true;
-    } else {
-        printf("Error: Invalid route format: %s\n", route);
-        return false;
+    if (result) {
+        result = apply_route_updates(updates, count, backend);
     }
+
+    for (int i = 0; i < count; i++) {
+        free((char*)updates[i].value);
+    }
+    free(updates);
+    cJSON_Delete(body);
+    return result;
 }
 
 /**
@@ -1013,7 +1238,7 @@ void update_sim_DCU_field_settings(sim_engine_t* sim_engine) {
 
 
 /**
- * Gets a field value from a JSON file using a dot-separated path
+ * Gets a field value from a dataset in the telemetry store using a dot-separated path
  *
  * @param filename Name of the JSON file (e.g., "ROVER", "EVA")
  * @param field_path Dot-separated path to the field (e.g., "pr_telemetry.brakes" or "telemetry.eva1.batt")
@@ -1021,35 +1246,18 @@ void update_sim_DCU_field_settings(sim_engine_t* sim_engine) {
  * @return Field value as double, or default_value if not found
  */
 double get_field_from_json(const char* filename, const char* field_path, double default_value) {
-    cJSON* json = get_json_file(filename);
-    if (json == NULL) {
+    int dataset = store_dataset_from_name(filename);
+    if (dataset < 0) {
         return default_value;
     }
-    
-    // Parse the field path
-    char path_copy[256];
-    strncpy(path_copy, field_path, sizeof(path_copy) - 1);
-    path_copy[sizeof(path_copy) - 1] = '\0';
-    
-    cJSON* current_object = json;
-    char* field_parts[10];
-    int field_part_count = 0;
-    
-    // Split field path by dots
-    char* token = strtok(path_copy, ".");
-    while (token != NULL && field_part_count < 10) {
-        field_parts[field_part_count++] = token;
-        token = strtok(NULL, ".");
-    }
-    
-    // Navigate through the JSON path
-    for (int i = 0; i < field_part_count; i++) {
-        cJSON* next_object = cJSON_GetObjectItemCaseSensitive(current_object, field_parts[i]);
-        if (next_object == NULL) {
-            cJSON_Delete(json);
-            return default_value;
-        }
-        current_object = next_object;
+
+    store_lock(telemetry_store);
+
+    // Look up the path in the resident dataset
+    cJSON* current_object = store_find(telemetry_store, dataset, field_path);
+    if (current_object == NULL) {
+        store_unlock(telemetry_store);
+        return default_value;
     }
     
     // Extract the value based on type
@@ -1066,30 +1274,50 @@ double get_field_from_json(const char* filename, const char* field_path, double
             result = parsed_value;
         }
     }
-    
-    cJSON_Delete(json);
+
+    store_unlock(telemetry_store);
     return result;
 }
 
+/**
+ * Binds external_value fields of the simulation engine to a handle in the telemetry store
+ *
+ * @param file_path Data file the field lives in (e.g., "ROVER.json")
+ * @param field_path Dot-separated path to the field (e.g., "pr_telemetry.throttle")
+ * @return Store handle, or STORE_INVALID_HANDLE if the field does not exist
+ */
+static int bind_external_store_value(const char* file_path, const char* field_path) {
+    return store_resolve(telemetry_store, store_dataset_from_name(file_path), field_path);
+}
+
+/**
+ * Supplies external_value fields of the simulation engine from the telemetry store
+ *
+ * @param handle Handle returned by bind_external_store_value
+ * @param value Receives the numeric value, booleans are converted to 1.0 or 0.0
+ * @return true if the field is a number or boolean, false otherwise
+ */
+static bool read_external_store_value(int handle, float* value) {
+    double number;
+    if (!store_handle_get_number(telemetry_store, handle, &number)) {
+        return false;
+    }
+
+    *value = (float)number;
+    return true;
+}
+
 /**
  * Updates EVA station timing based on started states
  * Increments time for stations that are started and marks completed when stopped
  */
 void update_eva_station_timing(void) {
-    // Load current EVA JSON data
-    cJSON* eva_json = get_json_file("EVA");
-    if (eva_json == NULL) {
-        return;
-    }
-
-    // Get the status section
-    cJSON* status = cJSON_GetObjectItemCaseSensitive(eva_json, "status");
+    // Get the status section of the resident EVA data
+    cJSON* status = store_find(telemetry_store, STORE_DATASET_EVA, "status");
     if (status == NULL) {
-        cJSON_Delete(eva_json);
         return;
     }
 
-    bool json_modified = false;
     const char* stations[] = {"uia", "dcu", "spec"};
     int num_stations = sizeof(stations) / sizeof(stations[0]);
 
@@ -1117,53 +1345,27 @@ void update_eva_station_timing(void) {
 
         // If station is started, increment time
         if (is_started) {
-            cJSON_SetNumberValue(time_field, current_time + 1.0);
-            json_modified = true;
+            store_set_number(telemetry_store, STORE_DATASET_EVA, time_field, current_time + 1.0);
         }
 
         // Check if station was just stopped (completed should be set when started changes from true to false)
         // This is handled by the frontend toggle logic, but we can ensure completed status is consistent
         if (!is_started && completed_field != NULL && cJSON_IsFalse(completed_field) && current_time > 0) {
-            cJSON_SetBoolValue(completed_field, true);
-            json_modified = true;
-        }
-    }
-
-    // Save changes if JSON was modified
-    if (json_modified) {
-        char filepath[100];
-        snprintf(filepath, sizeof(filepath), "data/EVA.json");
-
-        char* json_str = cJSON_Print(eva_json);
-        FILE* fp = fopen(filepath, "w");
-        if (fp) {
-            fputs(json_str, fp);
-            fclose(fp);
+            store_set_bool(telemetry_store, STORE_DATASET_EVA, completed_field, true);
         }
-        free(json_str);
     }
-
-    cJSON_Delete(eva_json);
 }
 
 /**
  * Resets EVA station timing by setting all station times to 0 and completed status to false
  */
 void reset_eva_station_timing(void) {
-    // Load current EVA JSON data
-    cJSON* eva_json = get_json_file("EVA");
-    if (eva_json == NULL) {
-        return;
-    }
-
-    // Get the status section
-    cJSON* status = cJSON_GetObjectItemCaseSensitive(eva_json, "status");
+    // Get the status section of the resident EVA data
+    cJSON* status = store_find(telemetry_store, STORE_DATASET_EVA, "status");
     if (status == NULL) {
-        cJSON_Delete(eva_json);
         return;
     }
 
-    bool json_modified = false;
     const char* stations[] = {"uia", "dcu", "spec"};
     int num_stations = sizeof(stations) / sizeof(stations[0]);
 
@@ -1177,38 +1379,18 @@ void reset_eva_station_timing(void) {
             continue;
         }
 
-        // Get time and completed fields
+        // Reset time to 0 and completed status to false
         cJSON* time_field = cJSON_GetObjectItemCaseSensitive(station, "time");
         cJSON* completed_field = cJSON_GetObjectItemCaseSensitive(station, "completed");
 
-        // Reset time to 0
         if (time_field != NULL) {
-            cJSON_SetNumberValue(time_field, 0.0);
-            json_modified = true;
+            store_set_number(telemetry_store, STORE_DATASET_EVA, time_field, 0.0);
         }
 
-        // Reset completed status to false
         if (completed_field != NULL) {
-            cJSON_SetBoolValue(completed_field, false);
-            json_modified = true;
-        }
-    }
-
-    // Save changes if JSON was modified
-    if (json_modified) {
-        char filepath[100];
-        snprintf(filepath, sizeof(filepath), "data/EVA.json");
-
-        char* json_str = cJSON_Print(eva_json);
-        FILE* fp = fopen(filepath, "w");
-        if (fp) {
-            fputs(json_str, fp);
-            fclose(fp);
+            store_set_bool(telemetry_store, STORE_DATASET_EVA, completed_field, false);
         }
-        free(json_str);
     }
-
-    cJSON_Delete(eva_json);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////
@@ -1251,19 +1433,17 @@ bool big_endian() {
 }
 
 /**
- * Extracts boolean value from UDP data (bytes 4-7 as float, non-zero = true)
+ * Extracts boolean value from UDP data (big-endian float, non-zero = true)
  *
  * @param data UDP data buffer
  * @return Boolean value
  */
 bool extract_bool_value(unsigned char* data) {
-    float bool_float;
-    memcpy(&bool_float, data, 4);
-    return bool_float != 0.0f;
+    return extract_float_value(data) != 0.0f;
 }
 
 /**
- * Extracts float value from UDP data (bytes 4-7)
+ * Extracts float value from UDP data, UDP packets are always big-endian
  *
  * @param data UDP data buffer
  * @return Float value
@@ -1271,5 +1451,8 @@ bool extract_bool_value(unsigned char* data) {
 float extract_float_value(unsigned char* data) {
     float value;
     memcpy(&value, data, 4);
+    if (!big_endian()) {
+        reverse_bytes((unsigned char*)&value);
+    }
     return value;
 }
\ No newline at end of file
@@ -6,9 +6,29 @@
 #include <stdint.h>
 #include "lib/cjson/cJSON.h"
 #include "lib/simulation/sim_engine.h"
+#include "store.h"
 #include <stdlib.h>
 #include <stdio.h>  
 
+#define LIDAR_NUM_POINTS 17 // number of LiDAR points expected from the DUST sim to allocate in memory
+
+// Range of UDP POST commands, each command in udp_command_mappings must fall inside it
+#define UDP_POST_COMMAND_MIN 1000
+#define UDP_POST_COMMAND_MAX 2999
+
+// Several POST commands applied together, the payload is a list of command (uint32) and value (4 bytes) pairs
+#define UDP_BATCH_POST_COMMAND 3200
+#define UDP_BATCH_POST_ENTRY_SIZE 8
+
+// UDP GET commands for the fixed-layout binary records, see binary_telemetry_layouts below
+#define UDP_GET_BINARY_ROVER 10
+#define UDP_GET_BINARY_EVA 11
+#define UDP_GET_BINARY_LTV 12
+
+// Version of the binary record layouts, increment it whenever a layout table below changes
+#define BINARY_TELEMETRY_SCHEMA_VERSION 1
+#define BINARY_TELEMETRY_HEADER_SIZE 12 // schema version, dataset version and value count, 4 bytes each
+
 // UDP command mapping structure
 typedef struct {
     unsigned int command;
@@ -16,6 +36,12 @@ typedef struct {
     const char* data_type;   // bool or float, this makes the parsing easier
 } udp_command_mapping_t;
 
+// Binary record field, every value is sent as a big-endian 32-bit float
+typedef struct {
+    const char* path;        // full dot-separated path like "rover.pr_telemetry.brakes"
+    int count;               // number of values, LIDAR_NUM_POINTS for the LiDAR array and 1 otherwise
+} binary_telemetry_field_t;
+
 struct backend_data_t {
     // Timing information
     uint32_t start_time;
@@ -27,6 +53,9 @@ struct backend_data_t {
 
     // Simulation engine
     sim_engine_t* sim_engine;
+
+    // Resident EVA, ROVER, and LTV telemetry, the data folder is only a persisted view of this
+    struct telemetry_store_t* store;
 };
 
 // Backend Lifecycle Functions
@@ -35,14 +64,15 @@ void increment_simulation(struct backend_data_t* backend);
 void cleanup_backend(struct backend_data_t*  backend);
 
 // UDP Request Handlers
-void handle_udp_get_request(unsigned int command, unsigned char* data, struct backend_data_t* backend);
-bool handle_udp_post_request(unsigned int command, unsigned char* data, struct backend_data_t* backend);
+int handle_udp_get_request(unsigned int command, bool* binary, struct backend_data_t* backend);
+int udp_get_command_dataset(unsigned int command, bool* binary);
+bool handle_udp_post_request(unsigned int command, unsigned char* data, int data_length, struct backend_data_t* backend);
+bool handle_udp_batch_post_request(unsigned char* data, int data_length, struct backend_data_t* backend);
 
 // Data management
 void update_json_file(const char* filename, const char* section, const char* field_path, char* new_value);
 void sync_simulation_to_json(struct backend_data_t* backend);
 cJSON* get_json_file(const char* filename);
-void send_json_file(const char* filename, unsigned char* data);
 void update_eva_station_timing(void);
 void reset_eva_station_timing(void);
 void update_sim_DCU_field_settings(sim_engine_t* sim_engine);
@@ -58,6 +88,7 @@ void update_remaining_errors(sim_engine_t* engine);
 void reverse_bytes(unsigned char* bytes);
 bool big_endian();
 bool html_form_json_update(char* request_content, struct backend_data_t* backend);
+bool html_json_batch_update(const char* request_content, struct backend_data_t* backend);
 double get_field_from_json(const char* filename, const char* field_path, double default_value);
 
 // UDP data extraction helpers
@@ -87,7 +118,7 @@ static const udp_command_mapping_t udp_command_mappings[] = {
     {1118, "rover.pr_telemetry.speed", "float"},
     {1119, "rover.pr_telemetry.surface_incline", "float"},
 
-    {1130, "rover.pr_telemetry.lidar", "array<float>"}, // LiDAR is float array, this data type is handled separately in server.c
+    {1130, "rover.pr_telemetry.lidar", "array<float>"}, // LiDAR is an array of LIDAR_NUM_POINTS floats
     {1131, "rover.pr_telemetry.sunlight", "float"},
     {1132, "ltv.signal.strength", "float"},
 
@@ -135,4 +166,93 @@ static const udp_command_mapping_t udp_command_mappings[] = {
     {0, NULL, NULL} // Sentinel
 };
 
+// Binary record layouts, one value per field in this order (arrays expand to count values).
+// Fields that belong to a simulation component (EVA suit telemetry and rover pr_telemetry) are read straight
+// from the simulation engine, everything else from the telemetry store. Missing values are sent as NaN.
+static const binary_telemetry_field_t binary_rover_layout[] = {
+    {"rover.pr_telemetry.cabin_heating", 1},
+    {"rover.pr_telemetry.cabin_cooling", 1},
+    {"rover.pr_telemetry.co2_scrubber", 1},
+    {"rover.pr_telemetry.lights_on", 1},
+    {"rover.pr_telemetry.brakes", 1},
+    {"rover.pr_telemetry.throttle", 1},
+    {"rover.pr_telemetry.steering", 1},
+    {"rover.pr_telemetry.rover_pos_x", 1},
+    {"rover.pr_telemetry.rover_pos_y", 1},
+    {"rover.pr_telemetry.rover_pos_z", 1},
+    {"rover.pr_telemetry.heading", 1},
+    {"rover.pr_telemetry.pitch", 1},
+    {"rover.pr_telemetry.roll", 1},
+    {"rover.pr_telemetry.distance_traveled", 1},
+    {"rover.pr_telemetry.speed", 1},
+    {"rover.pr_telemetry.sunlight", 1},
+    {"rover.pr_telemetry.surface_incline", 1},
+    {"rover.pr_telemetry.lidar", LIDAR_NUM_POINTS},
+    {"rover.pr_telemetry.oxygen_tank", 1},
+    {"rover.pr_telemetry.oxygen_pressure", 1},
+    {"rover.pr_telemetry.fan_pri_rpm", 1},
+    {"rover.pr_telemetry.fan_sec_rpm", 1},
+    {"rover.pr_telemetry.cabin_pressure", 1},
+    {"rover.pr_telemetry.cabin_temperature", 1},
+    {"rover.pr_telemetry.battery_level", 1},
+    {"rover.pr_telemetry.external_temp", 1},
+    {"rover.pr_telemetry.coolant_pressure", 1},
+    {"rover.pr_telemetry.coolant_storage", 1},
+    {"rover.pr_telemetry.rover_elapsed_time", 1},
+    {"rover.pr_telemetry.sim_running", 1},
+    {"rover.pr_telemetry.dust_connected", 1},
+    {"rover.pr_telemetry.distance_from_base", 1},
+    {NULL, 0} // Sentinel
+};
+
+// EVA suit fields shared by both suits, each suit's battery fields come first since they differ between suits
+#define BINARY_EVA_SUIT_FIELDS(suit) \
+    {"eva.telemetry." suit ".oxy_pri_storage", 1}, \
+    {"eva.telemetry." suit ".oxy_sec_storage", 1}, \
+    {"eva.telemetry." suit ".oxy_pri_pressure", 1}, \
+    {"eva.telemetry." suit ".oxy_sec_pressure", 1}, \
+    {"eva.telemetry." suit ".suit_pressure_oxy", 1}, \
+    {"eva.telemetry." suit ".suit_pressure_co2", 1}, \
+    {"eva.telemetry." suit ".suit_pressure_other", 1}, \
+    {"eva.telemetry." suit ".suit_pressure_total", 1}, \
+    {"eva.telemetry." suit ".helmet_pressure_co2", 1}, \
+    {"eva.telemetry." suit ".fan_pri_rpm", 1}, \
+    {"eva.telemetry." suit ".fan_sec_rpm", 1}, \
+    {"eva.telemetry." suit ".scrubber_a_co2_storage", 1}, \
+    {"eva.telemetry." suit ".scrubber_b_co2_storage", 1}, \
+    {"eva.telemetry." suit ".temperature", 1}, \
+    {"eva.telemetry." suit ".coolant_storage", 1}, \
+    {"eva.telemetry." suit ".coolant_gas_pressure", 1}, \
+    {"eva.telemetry." suit ".coolant_liquid_pressure", 1}, \
+    {"eva.telemetry." suit ".heart_rate", 1}, \
+    {"eva.telemetry." suit ".oxy_consumption", 1}, \
+    {"eva.telemetry." suit ".co2_production", 1}, \
+    {"eva.telemetry." suit ".eva_elapsed_time", 1}
+
+static const binary_telemetry_field_t binary_eva_layout[] = {
+    {"eva.status.started", 1},
+    {"eva.telemetry.eva1.primary_battery_level", 1},
+    {"eva.telemetry.eva1.secondary_battery_level", 1},
+    BINARY_EVA_SUIT_FIELDS("eva1"),
+    {"eva.telemetry.eva2.battery_level", 1},
+    BINARY_EVA_SUIT_FIELDS("eva2"),
+    {NULL, 0} // Sentinel
+};
+
+static const binary_telemetry_field_t binary_ltv_layout[] = {
+    {"ltv.location.last_known_x", 1},
+    {"ltv.location.last_known_y", 1},
+    {"ltv.signal.strength", 1},
+    {"ltv.signal.pings_left", 1},
+    {"ltv.signal.ping_requested", 1},
+    {"ltv.errors.recovery_mode", 1},
+    {"ltv.errors.dust_sensor", 1},
+    {"ltv.errors.power_distribution", 1},
+    {"ltv.errors.nav_system", 1},
+    {"ltv.errors.electronic_heater", 1},
+    {"ltv.errors.comms", 1},
+    {"ltv.errors.fuse", 1},
+    {NULL, 0} // Sentinel
+};
+
 #endif // DATA_H
\ No newline at end of file
@@ -0,0 +1,357 @@
+// http.c - incremental HTTP/1.1 request parser
+
+#include "http.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static http_parse_result_t parse_line(struct http_parser_t* parser, char* buffer, int start, int end);
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Parser State
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Prepares a parser for the first request of a connection.
+ */
+void http_parser_init(struct http_parser_t* parser) {
+    memset(parser, 0, sizeof(struct http_parser_t));
+    parser->state = HTTP_STATE_REQUEST_LINE;
+    parser->content_length = -1;
+}
+
+/**
+ * Frees the body of the handled request and prepares the parser for the next request on the connection.
+ * The caller removes the handled request from the front of the buffer first.
+ */
+void http_parser_reset(struct http_parser_t* parser) {
+    free(parser->body);
+    http_parser_init(parser);
+}
+
+/**
+ * Checks whether the request line and headers have been parsed, the body may still be on its way.
+ */
+bool http_headers_complete(const struct http_parser_t* parser) {
+    return parser->header_length > 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Helpers
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Compares a header name case-insensitively, the name is not null-terminated in the buffer.
+ */
+static bool header_name_is(const char* name, int name_length, const char* expected) {
+    return name_length == (int)strlen(expected) && strncasecmp(name, expected, name_length) == 0;
+}
+
+/**
+ * Looks for a token in a comma-separated header value such as "keep-alive, Upgrade".
+ */
+static bool header_value_has_token(const char* value, int value_length, const char* token) {
+    int token_length = (int)strlen(token);
+    const char* end = value + value_length;
+
+    while (value < end) {
+        while (value < end && (*value == ' ' || *value == '\t' || *value == ',')) value++;
+        const char* item = value;
+        while (value < end && *value != ',') value++;
+
+        const char* item_end = value;
+        while (item_end > item && (item_end[-1] == ' ' || item_end[-1] == '\t')) item_end--;
+        if (item_end - item == token_length && strncasecmp(item, token, token_length) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Appends decoded body bytes, the body buffer grows by doubling up to HTTP_MAX_BODY_SIZE.
+ *
+ * @return false if the body would be longer than HTTP_MAX_BODY_SIZE or memory ran out
+ */
+static bool append_body(struct http_parser_t* parser, const char* data, size_t length) {
+    if (parser->body_length + length > HTTP_MAX_BODY_SIZE) {
+        return false;
+    }
+
+    // One extra byte for the null terminator
+    if (parser->body_length + length + 1 > parser->body_capacity) {
+        size_t capacity = parser->body_capacity ? parser->body_capacity : 256;
+        while (capacity < parser->body_length + length + 1) capacity *= 2;
+        if (capacity > HTTP_MAX_BODY_SIZE + 1) capacity = HTTP_MAX_BODY_SIZE + 1;
+
+        char* body = realloc(parser->body, capacity);
+        if (!body) {
+            return false;
+        }
+        parser->body = body;
+        parser->body_capacity = capacity;
+    }
+
+    memcpy(parser->body + parser->body_length, data, length);
+    parser->body_length += length;
+    parser->body[parser->body_length] = 0;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Lines
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Parses "METHOD target HTTP/1.x", only the offsets of the target are kept.
+ */
+static http_parse_result_t parse_request_line(struct http_parser_t* parser, char* buffer, int start, int end) {
+    const char* line = buffer + start;
+    int length = end - start;
+
+    const char* method_end = memchr(line, ' ', length);
+    if (!method_end) {
+        return HTTP_PARSE_INVALID;
+    }
+    const char* target = method_end + 1;
+    const char* target_end = memchr(target, ' ', line + length - target);
+    if (!target_end || target_end == target) {
+        return HTTP_PARSE_INVALID;
+    }
+    const char* version = target_end + 1;
+    int version_length = (int)(line + length - version);
+    if (version_length != 8 || strncmp(version, "HTTP/1.", 7) != 0) {
+        return HTTP_PARSE_INVALID;
+    }
+
+    int method_length = (int)(method_end - line);
+    if (method_length == 3 && strncmp(line, "GET", 3) == 0) {
+        parser->method = HTTP_METHOD_GET;
+    } else if (method_length == 4 && strncmp(line, "POST", 4) == 0) {
+        parser->method = HTTP_METHOD_POST;
+    } else {
+        parser->method = HTTP_METHOD_OTHER;
+    }
+
+    parser->target_start = (int)(target - buffer);
+    parser->target_length = (int)(target_end - target);
+
+    // HTTP/1.1 connections stay open unless the client asks otherwise, HTTP/1.0 connections close
+    parser->keep_alive = version[7] == '1';
+    parser->state = HTTP_STATE_HEADERS;
+    return HTTP_PARSE_INCOMPLETE;
+}
+
+/**
+ * Parses one "Name: value" header line, only the headers that decide how the request is read are kept.
+ * Other headers such as If-None-Match are looked up with get_request_header once the request is complete.
+ */
+static http_parse_result_t parse_header_line(struct http_parser_t* parser, char* buffer, int start, int end) {
+    const char* name = buffer + start;
+    const char* colon = memchr(name, ':', end - start);
+    if (!colon || colon == name) {
+        return HTTP_PARSE_INVALID;
+    }
+    int name_length = (int)(colon - name);
+
+    const char* value = colon + 1;
+    const char* value_end = buffer + end;
+    while (value < value_end && (*value == ' ' || *value == '\t')) value++;
+    while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t')) value_end--;
+    int value_length = (int)(value_end - value);
+
+    if (header_name_is(name, name_length, "Content-Length")) {
+        if (value_length == 0 || value_length > 18) {
+            return HTTP_PARSE_INVALID;
+        }
+        long long content_length = 0;
+        for (int i = 0; i < value_length; i++) {
+            if (value[i] < '0' || value[i] > '9') {
+                return HTTP_PARSE_INVALID;
+            }
+            content_length = content_length * 10 + (value[i] - '0');
+        }
+
+        // Repeated headers have to agree, otherwise the end of the body is ambiguous
+        if (parser->content_length >= 0 && parser->content_length != content_length) {
+            return HTTP_PARSE_INVALID;
+        }
+        parser->content_length = content_length;
+    } else if (header_name_is(name, name_length, "Transfer-Encoding")) {
+        // Only chunked is understood, a body in any other coding can't be delimited
+        if (!header_value_has_token(value, value_length, "chunked")) {
+            return HTTP_PARSE_INVALID;
+        }
+        parser->chunked = true;
+    } else if (header_name_is(name, name_length, "Connection")) {
+        if (header_value_has_token(value, value_length, "close")) {
+            parser->keep_alive = false;
+        } else if (header_value_has_token(value, value_length, "keep-alive")) {
+            parser->keep_alive = true;
+        }
+    } else if (header_name_is(name, name_length, "Expect")) {
+        parser->expect_continue = header_value_has_token(value, value_length, "100-continue");
+    } else if (header_name_is(name, name_length, "Content-Type")) {
+        parser->json_body = value_length >= 16 && strncasecmp(value, "application/json", 16) == 0;
+    }
+
+    return HTTP_PARSE_INCOMPLETE;
+}
+
+/**
+ * Decides how the body is read once the blank line after the headers arrives.
+ */
+static http_parse_result_t finish_headers(struct http_parser_t* parser) {
+    parser->header_length = parser->offset;
+
+    // Transfer-Encoding overrides Content-Length (RFC 9112 section 6.3)
+    if (parser->chunked) {
+        parser->state = HTTP_STATE_CHUNK_SIZE;
+    } else if (parser->content_length > HTTP_MAX_BODY_SIZE) {
+        return HTTP_PARSE_BODY_TOO_LARGE;
+    } else if (parser->content_length > 0) {
+        parser->remaining = (size_t)parser->content_length;
+        parser->state = HTTP_STATE_BODY;
+    } else {
+        parser->state = HTTP_STATE_COMPLETE;
+    }
+
+    return HTTP_PARSE_INCOMPLETE;
+}
+
+/**
+ * Parses the hexadecimal size line in front of every chunk, chunk extensions after ';' are ignored.
+ */
+static http_parse_result_t parse_chunk_size(struct http_parser_t* parser, const char* line, int length) {
+    size_t size = 0;
+    int digits = 0;
+
+    for (; digits < length; digits++) {
+        char c = line[digits];
+        int value;
+        if (c >= '0' && c <= '9') value = c - '0';
+        else if (c >= 'a' && c <= 'f') value = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value = c - 'A' + 10;
+        else break;
+
+        size = size * 16 + value;
+        if (size > HTTP_MAX_BODY_SIZE) {
+            return HTTP_PARSE_BODY_TOO_LARGE;
+        }
+    }
+
+    if (digits == 0 || (digits < length && line[digits] != ';' && line[digits] != ' ' && line[digits] != '\t')) {
+        return HTTP_PARSE_INVALID;
+    }
+
+    if (size == 0) {
+        // Last chunk, only trailer fields and the blank line are left
+        parser->state = HTTP_STATE_TRAILERS;
+    } else {
+        parser->remaining = size;
+        parser->state = HTTP_STATE_CHUNK_DATA;
+    }
+
+    return HTTP_PARSE_INCOMPLETE;
+}
+
+/**
+ * Handles one complete line, end excludes the line terminator.
+ */
+static http_parse_result_t parse_line(struct http_parser_t* parser, char* buffer, int start, int end) {
+    int length = end - start;
+
+    switch (parser->state) {
+        case HTTP_STATE_REQUEST_LINE:
+            // Empty lines in front of a request are ignored (RFC 9112 section 2.2)
+            return length == 0 ? HTTP_PARSE_INCOMPLETE : parse_request_line(parser, buffer, start, end);
+        case HTTP_STATE_HEADERS:
+            return length == 0 ? finish_headers(parser) : parse_header_line(parser, buffer, start, end);
+        case HTTP_STATE_CHUNK_SIZE:
+            return parse_chunk_size(parser, buffer + start, length);
+        case HTTP_STATE_CHUNK_END:
+            if (length != 0) {
+                return HTTP_PARSE_INVALID;
+            }
+            parser->state = HTTP_STATE_CHUNK_SIZE;
+            return HTTP_PARSE_INCOMPLETE;
+        case HTTP_STATE_TRAILERS:
+            // Trailer fields are skipped, the blank line ends the request
+            if (length == 0) {
+                parser->state = HTTP_STATE_COMPLETE;
+            }
+            return HTTP_PARSE_INCOMPLETE;
+        default:
+            return HTTP_PARSE_INVALID;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Parsing
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Continues parsing the request at the front of the buffer with the bytes that arrived since the last call.
+ * Body bytes are moved out of the buffer into parser->body, so the buffer shrinks and *length is updated.
+ * Once the request is complete the request line and headers take up the first header_length bytes and any
+ * pipelined request follows right after them.
+ *
+ * @param parser Parser of the connection
+ * @param buffer Received bytes, starting with the request being parsed
+ * @param length Number of bytes in the buffer, updated when body bytes are moved out
+ * @return HTTP_PARSE_COMPLETE once the whole request has arrived, HTTP_PARSE_INCOMPLETE if more data is needed
+ */
+http_parse_result_t http_parse(struct http_parser_t* parser, char* buffer, int* length) {
+    http_parse_result_t result = HTTP_PARSE_INCOMPLETE;
+
+    while (result == HTTP_PARSE_INCOMPLETE && parser->state != HTTP_STATE_COMPLETE && parser->offset < *length) {
+        if (parser->state == HTTP_STATE_BODY || parser->state == HTTP_STATE_CHUNK_DATA) {
+            size_t available = (size_t)(*length - parser->offset);
+            size_t count = available < parser->remaining ? available : parser->remaining;
+            if (!append_body(parser, buffer + parser->offset, count)) {
+                result = HTTP_PARSE_BODY_TOO_LARGE;
+                break;
+            }
+
+            parser->offset += (int)count;
+            parser->line_start = parser->offset;
+            parser->remaining -= count;
+            if (parser->remaining == 0) {
+                parser->state = parser->state == HTTP_STATE_BODY ? HTTP_STATE_COMPLETE : HTTP_STATE_CHUNK_END;
+            }
+            continue;
+        }
+
+        // Line based states only look at the bytes after the last scan
+        char* newline = memchr(buffer + parser->offset, '\n', *length - parser->offset);
+        if (!newline) {
+            parser->offset = *length;
+            break;
+        }
+
+        int end = (int)(newline - buffer);
+        parser->offset = end + 1;
+        if (end > parser->line_start && buffer[end - 1] == '\r') {
+            end--;
+        }
+        result = parse_line(parser, buffer, parser->line_start, end);
+        parser->line_start = parser->offset;
+    }
+
+    // Move consumed body bytes and chunk framing out of the buffer, the headers stay where they are
+    if (parser->header_length > 0 && parser->line_start > parser->header_length) {
+        int consumed = parser->line_start - parser->header_length;
+        memmove(buffer + parser->header_length, buffer + parser->line_start, *length - parser->line_start);
+        *length -= consumed;
+        parser->offset -= consumed;
+        parser->line_start = parser->header_length;
+    }
+
+    if (result == HTTP_PARSE_INCOMPLETE && parser->state == HTTP_STATE_COMPLETE) {
+        result = HTTP_PARSE_COMPLETE;
+    }
+
+    return result;
+}
@@ -0,0 +1,74 @@
+#ifndef HTTP_H
+#define HTTP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Constants
+///////////////////////////////////////////////////////////////////////////////////
+
+#define HTTP_MAX_BODY_SIZE (1024 * 1024) // largest request body, after chunked transfer coding is removed
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Structs
+///////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+    HTTP_METHOD_OTHER,
+    HTTP_METHOD_GET,
+    HTTP_METHOD_POST
+} http_method_t;
+
+typedef enum {
+    HTTP_PARSE_INCOMPLETE,       // the request needs more data
+    HTTP_PARSE_COMPLETE,         // a whole request is parsed, the next one starts at header_length
+    HTTP_PARSE_INVALID,          // malformed request line, header, or chunk
+    HTTP_PARSE_BODY_TOO_LARGE    // body longer than HTTP_MAX_BODY_SIZE
+} http_parse_result_t;
+
+typedef enum {
+    HTTP_STATE_REQUEST_LINE,
+    HTTP_STATE_HEADERS,
+    HTTP_STATE_BODY,
+    HTTP_STATE_CHUNK_SIZE,
+    HTTP_STATE_CHUNK_DATA,
+    HTTP_STATE_CHUNK_END,        // CRLF after the data of a chunk
+    HTTP_STATE_TRAILERS,
+    HTTP_STATE_COMPLETE
+} http_parse_state_t;
+
+// Resumable HTTP/1.1 request parser. Every byte of the request buffer is looked at once, a parse that runs out
+// of data picks up where it stopped when more arrives. The request line and headers stay at the front of the
+// buffer, body bytes are moved into a separate buffer as they arrive so bodies aren't limited by its size.
+struct http_parser_t {
+    http_parse_state_t state;
+    int offset;                  // bytes of the request buffer already scanned
+    int line_start;              // start of the line being scanned, body bytes before it have been consumed
+    int header_length;           // request line and headers including the blank line, 0 until they are complete
+
+    http_method_t method;
+    int target_start;            // request target e.g. "/data/EVA.json?x=1" as an offset into the buffer
+    int target_length;
+    bool keep_alive;             // HTTP/1.1 default or what the Connection header asks for
+    bool chunked;                // body sent with Transfer-Encoding: chunked
+    bool expect_continue;        // client waits for "100 Continue" before sending the body
+    bool json_body;              // Content-Type is application/json
+    long long content_length;    // -1 if there is no Content-Length header
+    size_t remaining;            // bytes left of the body or of the current chunk
+
+    char* body;                  // null-terminated body, NULL if the request has none
+    size_t body_length;
+    size_t body_capacity;
+};
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                 Functions
+///////////////////////////////////////////////////////////////////////////////////
+
+void http_parser_init(struct http_parser_t* parser);
+void http_parser_reset(struct http_parser_t* parser);
+http_parse_result_t http_parse(struct http_parser_t* parser, char* buffer, int* length);
+bool http_headers_complete(const struct http_parser_t* parser);
+
+#endif // HTTP_H
@@ -0,0 +1,597 @@
+#include "gzip.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Constants
+///////////////////////////////////////////////////////////////////////////////////
+
+#define LITLEN_SYMBOLS 286          // literals 0-255, end of block 256, lengths 257-285
+#define FIXED_LITLEN_SYMBOLS 288    // the fixed code also gives the unused symbols 286 and 287 a code
+#define DIST_SYMBOLS 30
+#define CODELEN_SYMBOLS 19
+#define END_OF_BLOCK 256
+#define MAX_CODE_LENGTH 15
+#define MAX_CODELEN_LENGTH 7
+#define MIN_MATCH 3
+#define MAX_MATCH 258
+#define MAX_STORED_LENGTH 65535
+#define HASH_BITS 15
+
+static const uint16_t length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+    4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Order the code length code lengths are written in, least likely last so trailing zeros can be left out
+static const uint8_t codelen_order[CODELEN_SYMBOLS] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Structs
+///////////////////////////////////////////////////////////////////////////////////
+
+// Output buffer that DEFLATE bits are packed into, least significant bit first
+struct bit_writer_t {
+    unsigned char* data;
+    size_t length;
+    size_t capacity;
+    uint64_t bits;
+    int bit_count;
+    bool failed;                 // set when the buffer could not grow, everything written after is dropped
+};
+
+// A literal byte (distance 0) or a match of length bytes starting distance bytes back
+struct deflate_symbol_t {
+    uint16_t value;
+    uint16_t distance;
+};
+
+// Huffman code for one alphabet, codes are stored bit-reversed so they can be written LSB first
+struct huffman_code_t {
+    uint8_t lengths[FIXED_LITLEN_SYMBOLS];
+    uint16_t codes[FIXED_LITLEN_SYMBOLS];
+};
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                 Bit Output
+///////////////////////////////////////////////////////////////////////////////////
+
+static void put_byte(struct bit_writer_t* writer, unsigned char byte) {
+    if (writer->length == writer->capacity) {
+        size_t capacity = writer->capacity ? writer->capacity * 2 : 1024;
+        unsigned char* data = writer->failed ? NULL : realloc(writer->data, capacity);
+        if (!data) {
+            writer->failed = true;
+            return;
+        }
+        writer->data = data;
+        writer->capacity = capacity;
+    }
+    writer->data[writer->length++] = byte;
+}
+
+static void put_bits(struct bit_writer_t* writer, uint32_t value, int count) {
+    writer->bits |= (uint64_t)value << writer->bit_count;
+    writer->bit_count += count;
+    while (writer->bit_count >= 8) {
+        put_byte(writer, (unsigned char)(writer->bits & 0xFF));
+        writer->bits >>= 8;
+        writer->bit_count -= 8;
+    }
+}
+
+static void align_to_byte(struct bit_writer_t* writer) {
+    if (writer->bit_count > 0) {
+        put_bits(writer, 0, 8 - writer->bit_count);
+    }
+}
+
+static void put_uint32_le(struct bit_writer_t* writer, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        put_byte(writer, (unsigned char)(value >> (8 * i)));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                               Huffman Codes
+///////////////////////////////////////////////////////////////////////////////////
+
+struct huffman_leaf_t {
+    uint32_t frequency;
+    int symbol;
+};
+
+static int compare_leaves(const void* a, const void* b) {
+    const struct huffman_leaf_t* left = a;
+    const struct huffman_leaf_t* right = b;
+    if (left->frequency != right->frequency) {
+        return left->frequency < right->frequency ? -1 : 1;
+    }
+    return left->symbol - right->symbol;
+}
+
+/**
+ * Computes Huffman code lengths no longer than max_length. Symbols that are used get a length of at least 1,
+ * the caller makes sure at least two symbols are used so the code is complete.
+ * Frequencies are flattened until the tree fits, which is rarely needed for the inputs we compress.
+ *
+ * @param frequencies Number of times each symbol is used
+ * @param symbol_count Size of the alphabet
+ * @param max_length Longest code allowed
+ * @param lengths Output code length of every symbol, 0 for unused symbols
+ */
+static void build_code_lengths(const uint32_t* frequencies, int symbol_count, int max_length, uint8_t* lengths) {
+    struct huffman_leaf_t leaves[LITLEN_SYMBOLS];
+    uint32_t weights[2 * LITLEN_SYMBOLS];
+    int parents[2 * LITLEN_SYMBOLS];
+    int depths[2 * LITLEN_SYMBOLS];
+
+    int leaf_count = 0;
+    for (int i = 0; i < symbol_count; i++) {
+        lengths[i] = 0;
+        if (frequencies[i]) {
+            leaves[leaf_count].frequency = frequencies[i];
+            leaves[leaf_count].symbol = i;
+            leaf_count++;
+        }
+    }
+
+    if (leaf_count == 1) {
+        lengths[leaves[0].symbol] = 1;
+    }
+    if (leaf_count < 2) {
+        return;
+    }
+
+    while (true) {
+        qsort(leaves, leaf_count, sizeof(struct huffman_leaf_t), compare_leaves);
+        for (int i = 0; i < leaf_count; i++) {
+            weights[i] = leaves[i].frequency;
+        }
+
+        // Two-queue construction, merged nodes are created in non-decreasing weight order after the sorted leaves
+        int next_leaf = 0;
+        int next_internal = leaf_count;
+        int node_count = leaf_count;
+        for (int merge = 0; merge < leaf_count - 1; merge++) {
+            int children[2];
+            for (int c = 0; c < 2; c++) {
+                if (next_leaf < leaf_count &&
+                    (next_internal >= node_count || weights[next_leaf] <= weights[next_internal])) {
+                    children[c] = next_leaf++;
+                } else {
+                    children[c] = next_internal++;
+                }
+            }
+            weights[node_count] = weights[children[0]] + weights[children[1]];
+            parents[children[0]] = node_count;
+            parents[children[1]] = node_count;
+            node_count++;
+        }
+
+        // Parents always come after their children, so depths can be filled in from the root down
+        int longest = 0;
+        depths[node_count - 1] = 0;
+        for (int i = node_count - 2; i >= 0; i--) {
+            depths[i] = depths[parents[i]] + 1;
+            if (i < leaf_count && depths[i] > longest) {
+                longest = depths[i];
+            }
+        }
+
+        if (longest <= max_length) {
+            for (int i = 0; i < leaf_count; i++) {
+                lengths[leaves[i].symbol] = (uint8_t)depths[i];
+            }
+            return;
+        }
+
+        for (int i = 0; i < leaf_count; i++) {
+            leaves[i].frequency = (leaves[i].frequency >> 1) | 1;
+        }
+    }
+}
+
+/**
+ * Assigns canonical codes (RFC 1951 section 3.2.2) to a set of code lengths.
+ */
+static void build_codes(struct huffman_code_t* code, int symbol_count) {
+    int length_counts[MAX_CODE_LENGTH + 1] = {0};
+    for (int i = 0; i < symbol_count; i++) {
+        length_counts[code->lengths[i]]++;
+    }
+    length_counts[0] = 0;
+
+    int next_code[MAX_CODE_LENGTH + 1];
+    int value = 0;
+    for (int bits = 1; bits <= MAX_CODE_LENGTH; bits++) {
+        value = (value + length_counts[bits - 1]) << 1;
+        next_code[bits] = value;
+    }
+
+    for (int i = 0; i < symbol_count; i++) {
+        int length = code->lengths[i];
+        code->codes[i] = 0;
+        if (length) {
+            int canonical = next_code[length]++;
+            int reversed = 0;
+            for (int bit = 0; bit < length; bit++) {
+                reversed = (reversed << 1) | ((canonical >> bit) & 1);
+            }
+            code->codes[i] = (uint16_t)reversed;
+        }
+    }
+}
+
+/**
+ * Makes sure at least two symbols of an alphabet are used, a code with a single symbol is incomplete.
+ */
+static void use_two_symbols(uint32_t* frequencies, int symbol_count) {
+    int used = 0;
+    for (int i = 0; i < symbol_count; i++) {
+        used += frequencies[i] != 0;
+    }
+    for (int i = 0; used < 2 && i < symbol_count; i++) {
+        if (!frequencies[i]) {
+            frequencies[i] = 1;
+            used++;
+        }
+    }
+}
+
+static int length_symbol(int length) {
+    int index = 28;
+    while (length_base[index] > length) {
+        index--;
+    }
+    return index;
+}
+
+static int distance_symbol(int distance) {
+    int index = 29;
+    while (dist_base[index] > distance) {
+        index--;
+    }
+    return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                Block Output
+///////////////////////////////////////////////////////////////////////////////////
+
+static void write_symbols(struct bit_writer_t* writer, const struct deflate_symbol_t* symbols, int symbol_count,
+                          const struct huffman_code_t* litlen, const struct huffman_code_t* dist) {
+    for (int i = 0; i < symbol_count; i++) {
+        if (symbols[i].distance == 0) {
+            put_bits(writer, litlen->codes[symbols[i].value], litlen->lengths[symbols[i].value]);
+            continue;
+        }
+
+        int length_index = length_symbol(symbols[i].value);
+        put_bits(writer, litlen->codes[257 + length_index], litlen->lengths[257 + length_index]);
+        put_bits(writer, symbols[i].value - length_base[length_index], length_extra[length_index]);
+
+        int dist_index = distance_symbol(symbols[i].distance);
+        put_bits(writer, dist->codes[dist_index], dist->lengths[dist_index]);
+        put_bits(writer, symbols[i].distance - dist_base[dist_index], dist_extra[dist_index]);
+    }
+    put_bits(writer, litlen->codes[END_OF_BLOCK], litlen->lengths[END_OF_BLOCK]);
+}
+
+static void write_stored(struct bit_writer_t* writer, const unsigned char* raw, size_t raw_length, bool final) {
+    do {
+        size_t length = raw_length > MAX_STORED_LENGTH ? MAX_STORED_LENGTH : raw_length;
+        bool last = final && length == raw_length;
+
+        put_bits(writer, last ? 1 : 0, 1);
+        put_bits(writer, 0, 2);
+        align_to_byte(writer);
+        put_bits(writer, (uint32_t)length, 16);
+        put_bits(writer, (uint32_t)(~length & 0xFFFF), 16);
+        for (size_t i = 0; i < length; i++) {
+            put_byte(writer, raw[i]);
+        }
+
+        raw += length;
+        raw_length -= length;
+    } while (raw_length > 0);
+}
+
+/**
+ * Writes one block of symbols with whichever of a dynamic Huffman, fixed Huffman, or stored block is smallest.
+ *
+ * @param writer Output
+ * @param symbols Literals and matches of the block
+ * @param symbol_count Number of symbols
+ * @param raw Input bytes the symbols encode, used for a stored block
+ * @param raw_length Number of input bytes
+ * @param final true for the last block of the stream
+ */
+static void write_block(struct bit_writer_t* writer, const struct deflate_symbol_t* symbols, int symbol_count,
+                        const unsigned char* raw, size_t raw_length, bool final) {
+    uint32_t litlen_frequencies[LITLEN_SYMBOLS] = {0};
+    uint32_t dist_frequencies[DIST_SYMBOLS] = {0};
+    uint64_t extra_bits = 0;
+
+    for (int i = 0; i < symbol_count; i++) {
+        if (symbols[i].distance == 0) {
+            litlen_frequencies[symbols[i].value]++;
+        } else {
+            int length_index = length_symbol(symbols[i].value);
+            int dist_index = distance_symbol(symbols[i].distance);
+            litlen_frequencies[257 + length_index]++;
+            dist_frequencies[dist_index]++;
+            extra_bits += length_extra[length_index] + dist_extra[dist_index];
+        }
+    }
+    litlen_frequencies[END_OF_BLOCK] = 1;
+
+    // Fixed code (RFC 1951 section 3.2.6), built over all 288 symbols or the canonical 9-bit codes of
+    // literals 144-255 come out wrong
+    struct huffman_code_t fixed_litlen, fixed_dist;
+    for (int i = 0; i < FIXED_LITLEN_SYMBOLS; i++) {
+        fixed_litlen.lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+    }
+    for (int i = 0; i < DIST_SYMBOLS; i++) {
+        fixed_dist.lengths[i] = 5;
+    }
+
+    // Dynamic code
+    struct huffman_code_t litlen, dist, codelen;
+    use_two_symbols(litlen_frequencies, LITLEN_SYMBOLS);
+    use_two_symbols(dist_frequencies, DIST_SYMBOLS);
+    build_code_lengths(litlen_frequencies, LITLEN_SYMBOLS, MAX_CODE_LENGTH, litlen.lengths);
+    build_code_lengths(dist_frequencies, DIST_SYMBOLS, MAX_CODE_LENGTH, dist.lengths);
+
+    int litlen_count = LITLEN_SYMBOLS;
+    while (litlen_count > 257 && litlen.lengths[litlen_count - 1] == 0) {
+        litlen_count--;
+    }
+    int dist_count = DIST_SYMBOLS;
+    while (dist_count > 1 && dist.lengths[dist_count - 1] == 0) {
+        dist_count--;
+    }
+
+    // Both sets of code lengths are run-length encoded together with the code length alphabet
+    uint8_t sequence[LITLEN_SYMBOLS + DIST_SYMBOLS];
+    int sequence_length = 0;
+    for (int i = 0; i < litlen_count; i++) {
+        sequence[sequence_length++] = litlen.lengths[i];
+    }
+    for (int i = 0; i < dist_count; i++) {
+        sequence[sequence_length++] = dist.lengths[i];
+    }
+
+    uint8_t rle_symbols[LITLEN_SYMBOLS + DIST_SYMBOLS];
+    uint8_t rle_extra[LITLEN_SYMBOLS + DIST_SYMBOLS];
+    int rle_count = 0;
+    uint32_t codelen_frequencies[CODELEN_SYMBOLS] = {0};
+
+    for (int i = 0; i < sequence_length;) {
+        int value = sequence[i];
+        int run = 1;
+        while (i + run < sequence_length && sequence[i + run] == value) {
+            run++;
+        }
+
+        if (value == 0 && run >= 3) {
+            int repeat = run > 138 ? 138 : run;
+            rle_symbols[rle_count] = repeat >= 11 ? 18 : 17;
+            rle_extra[rle_count] = (uint8_t)(repeat >= 11 ? repeat - 11 : repeat - 3);
+            i += repeat;
+        } else if (value != 0 && i > 0 && sequence[i - 1] == value && run >= 3) {
+            int repeat = run > 6 ? 6 : run;
+            rle_symbols[rle_count] = 16;
+            rle_extra[rle_count] = (uint8_t)(repeat - 3);
+            i += repeat;
+        } else {
+            rle_symbols[rle_count] = (uint8_t)value;
+            rle_extra[rle_count] = 0;
+            i++;
+        }
+        codelen_frequencies[rle_symbols[rle_count]]++;
+        rle_count++;
+    }
+
+    use_two_symbols(codelen_frequencies, CODELEN_SYMBOLS);
+    build_code_lengths(codelen_frequencies, CODELEN_SYMBOLS, MAX_CODELEN_LENGTH, codelen.lengths);
+
+    int codelen_count = CODELEN_SYMBOLS;
+    while (codelen_count > 4 && codelen.lengths[codelen_order[codelen_count - 1]] == 0) {
+        codelen_count--;
+    }
+
+    // Sizes of the three block types in bits
+    uint64_t dynamic_bits = 3 + 5 + 5 + 4 + 3 * (uint64_t)codelen_count + extra_bits;
+    uint64_t fixed_bits = 3 + extra_bits;
+    for (int i = 0; i < rle_count; i++) {
+        int symbol = rle_symbols[i];
+        dynamic_bits += codelen.lengths[symbol] + (symbol == 16 ? 2 : symbol == 17 ? 3 : symbol == 18 ? 7 : 0);
+    }
+    for (int i = 0; i < LITLEN_SYMBOLS; i++) {
+        dynamic_bits += (uint64_t)litlen_frequencies[i] * litlen.lengths[i];
+        fixed_bits += (uint64_t)litlen_frequencies[i] * fixed_litlen.lengths[i];
+    }
+    for (int i = 0; i < DIST_SYMBOLS; i++) {
+        dynamic_bits += (uint64_t)dist_frequencies[i] * dist.lengths[i];
+        fixed_bits += (uint64_t)dist_frequencies[i] * fixed_dist.lengths[i];
+    }
+    uint64_t stored_bits = 8 * ((uint64_t)raw_length + 5 * (raw_length / MAX_STORED_LENGTH + 1)) + 7;
+
+    if (stored_bits < dynamic_bits && stored_bits < fixed_bits) {
+        write_stored(writer, raw, raw_length, final);
+    } else if (fixed_bits <= dynamic_bits) {
+        build_codes(&fixed_litlen, FIXED_LITLEN_SYMBOLS);
+        build_codes(&fixed_dist, DIST_SYMBOLS);
+        put_bits(writer, final ? 1 : 0, 1);
+        put_bits(writer, 1, 2);
+        write_symbols(writer, symbols, symbol_count, &fixed_litlen, &fixed_dist);
+    } else {
+        build_codes(&litlen, LITLEN_SYMBOLS);
+        build_codes(&dist, DIST_SYMBOLS);
+        build_codes(&codelen, CODELEN_SYMBOLS);
+
+        put_bits(writer, final ? 1 : 0, 1);
+        put_bits(writer, 2, 2);
+        put_bits(writer, litlen_count - 257, 5);
+        put_bits(writer, dist_count - 1, 5);
+        put_bits(writer, codelen_count - 4, 4);
+        for (int i = 0; i < codelen_count; i++) {
+            put_bits(writer, codelen.lengths[codelen_order[i]], 3);
+        }
+        for (int i = 0; i < rle_count; i++) {
+            int symbol = rle_symbols[i];
+            put_bits(writer, codelen.codes[symbol], codelen.lengths[symbol]);
+            if (symbol >= 16) {
+                put_bits(writer, rle_extra[i], symbol == 16 ? 2 : symbol == 17 ? 3 : 7);
+            }
+        }
+        write_symbols(writer, symbols, symbol_count, &litlen, &dist);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                Compression
+///////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t hash_position(const unsigned char* data) {
+    uint32_t value = data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16);
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/**
+ * CRC-32 (IEEE 802.3), computed bitwise so there is no shared table to initialize.
+ */
+uint32_t gzip_crc32(const unsigned char* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * Compresses data into a gzip member. Matches are found through hash chains over a 32 KB window, and each
+ * block is written with the smallest of the three DEFLATE block types.
+ *
+ * @param data Input bytes
+ * @param length Number of input bytes
+ * @param compressed_length Output size of the returned buffer
+ * @return malloc'd gzip data, or NULL if memory ran out
+ */
+unsigned char* gzip_compress(const unsigned char* data, size_t length, size_t* compressed_length) {
+    struct bit_writer_t writer = {0};
+    int32_t* head = malloc(sizeof(int32_t) << HASH_BITS);
+    int32_t* previous = malloc(sizeof(int32_t) * GZIP_WINDOW_SIZE);
+    struct deflate_symbol_t* symbols = malloc(sizeof(struct deflate_symbol_t) * GZIP_BLOCK_SYMBOLS);
+
+    if (!head || !previous || !symbols) {
+        free(head);
+        free(previous);
+        free(symbols);
+        return NULL;
+    }
+    memset(head, 0xFF, sizeof(int32_t) << HASH_BITS);
+
+    // Member header: magic, deflate, no flags, no modification time, unknown OS
+    static const unsigned char header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+    for (int i = 0; i < 10; i++) {
+        put_byte(&writer, header[i]);
+    }
+
+    int symbol_count = 0;
+    size_t block_start = 0;
+    size_t position = 0;
+
+    while (position < length) {
+        int best_length = 0;
+        int best_distance = 0;
+
+        if (position + MIN_MATCH <= length) {
+            int max_length = length - position < MAX_MATCH ? (int)(length - position) : MAX_MATCH;
+            int32_t candidate = head[hash_position(data + position)];
+
+            for (int chain = 0; chain < GZIP_MAX_CHAIN && candidate >= 0 &&
+                                position - (size_t)candidate <= GZIP_WINDOW_SIZE; chain++) {
+                const unsigned char* match = data + candidate;
+                if (match[best_length] == data[position + best_length] && match[0] == data[position]) {
+                    int match_length = 0;
+                    while (match_length < max_length && match[match_length] == data[position + match_length]) {
+                        match_length++;
+                    }
+                    if (match_length > best_length) {
+                        best_length = match_length;
+                        best_distance = (int)(position - candidate);
+                        if (match_length == max_length) {
+                            break;
+                        }
+                    }
+                }
+
+                int32_t next = previous[candidate & (GZIP_WINDOW_SIZE - 1)];
+                if (next >= candidate) {
+                    break;
+                }
+                candidate = next;
+            }
+        }
+
+        // A short match far back costs more bits than the literals it replaces
+        if (best_length < MIN_MATCH || (best_length == MIN_MATCH && best_distance > 4096)) {
+            best_length = 1;
+            symbols[symbol_count].value = data[position];
+            symbols[symbol_count].distance = 0;
+        } else {
+            symbols[symbol_count].value = (uint16_t)best_length;
+            symbols[symbol_count].distance = (uint16_t)best_distance;
+        }
+        symbol_count++;
+
+        for (int i = 0; i < best_length; i++, position++) {
+            if (position + MIN_MATCH <= length) {
+                uint32_t hash = hash_position(data + position);
+                previous[position & (GZIP_WINDOW_SIZE - 1)] = head[hash];
+                head[hash] = (int32_t)position;
+            }
+        }
+
+        if (symbol_count == GZIP_BLOCK_SYMBOLS) {
+            write_block(&writer, symbols, symbol_count, data + block_start, position - block_start, false);
+            symbol_count = 0;
+            block_start = position;
+        }
+    }
+
+    write_block(&writer, symbols, symbol_count, data + block_start, position - block_start, true);
+    align_to_byte(&writer);
+
+    put_uint32_le(&writer, gzip_crc32(data, length));
+    put_uint32_le(&writer, (uint32_t)length);
+
+    free(head);
+    free(previous);
+    free(symbols);
+
+    if (writer.failed) {
+        free(writer.data);
+        return NULL;
+    }
+
+    *compressed_length = writer.length;
+    return writer.data;
+}
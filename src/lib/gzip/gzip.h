@@ -0,0 +1,26 @@
+#ifndef GZIP_H
+#define GZIP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Constants
+///////////////////////////////////////////////////////////////////////////////////
+
+#define GZIP_WINDOW_SIZE 32768      // largest match distance DEFLATE allows
+#define GZIP_MAX_CHAIN 128          // match candidates tried per position, higher compresses better but slower
+#define GZIP_BLOCK_SYMBOLS 32768    // literals and matches collected before a block is written
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                 Functions
+///////////////////////////////////////////////////////////////////////////////////
+
+// Compresses data into a gzip member (RFC 1952) holding one DEFLATE stream (RFC 1951).
+// Returns a malloc'd buffer the caller frees, or NULL if memory ran out.
+unsigned char* gzip_compress(const unsigned char* data, size_t length, size_t* compressed_length);
+
+// CRC-32 as used by gzip and PNG
+uint32_t gzip_crc32(const unsigned char* data, size_t length);
+
+#endif // GZIP_H
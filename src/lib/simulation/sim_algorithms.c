@@ -18,18 +18,13 @@
 sim_value_t sim_algo_sine_wave(sim_field_t* field, float current_time) {
     sim_value_t result = {0};
     
-    if (!field || !field->params) return result;
+    if (!field) return result;
     
     // Get parameters for the sine wave calculation
-    cJSON* base_value = cJSON_GetObjectItem(field->params, "base_value");
-    cJSON* amplitude = cJSON_GetObjectItem(field->params, "amplitude");
-    cJSON* frequency = cJSON_GetObjectItem(field->params, "frequency");
-    cJSON* phase_offset = cJSON_GetObjectItem(field->params, "phase_offset");
-    
-    float base = base_value && cJSON_IsNumber(base_value) ? (float)cJSON_GetNumberValue(base_value) : 0.0f;
-    float amp = amplitude && cJSON_IsNumber(amplitude) ? (float)cJSON_GetNumberValue(amplitude) : 1.0f;
-    float freq = frequency && cJSON_IsNumber(frequency) ? (float)cJSON_GetNumberValue(frequency) : 1.0f;
-    float phase = phase_offset && cJSON_IsNumber(phase_offset) ? (float)cJSON_GetNumberValue(phase_offset) : 0.0f;
+    float base = field->params.sine_wave.base_value;
+    float amp = field->params.sine_wave.amplitude;
+    float freq = field->params.sine_wave.frequency;
+    float phase = field->params.sine_wave.phase_offset;
     
     // Calculate sine wave value
     float elapsed_time = current_time - field->start_time;
@@ -44,16 +39,12 @@ sim_value_t sim_algo_sine_wave(sim_field_t* field, float current_time) {
 sim_value_t sim_algo_linear_decay(sim_field_t* field, float current_time) {
     sim_value_t result = {0};
     
-    if (!field || !field->params) return result;
+    if (!field) return result;
     
     // Get parameters
-    cJSON* start_value = cJSON_GetObjectItem(field->params, "start_value");
-    cJSON* end_value = cJSON_GetObjectItem(field->params, "end_value");
-    cJSON* duration = cJSON_GetObjectItem(field->params, "duration_seconds");
-    
-    float start_val = start_value && cJSON_IsNumber(start_value) ? (float)cJSON_GetNumberValue(start_value) : 100.0f;
-    float end_val = end_value && cJSON_IsNumber(end_value) ? (float)cJSON_GetNumberValue(end_value) : 0.0f;
-    float duration_sec = duration && cJSON_IsNumber(duration) ? (float)cJSON_GetNumberValue(duration) : 1.0f;
+    float start_val = field->params.linear_decay.start_value;
+    float end_val = field->params.linear_decay.end_value;
+    float duration_sec = field->params.linear_decay.duration_seconds;
     
     // Calculate current progress (0.0 to 1.0)
     float elapsed_time = current_time - field->start_time;
@@ -82,21 +73,17 @@ sim_value_t sim_algo_linear_decay(sim_field_t* field, float current_time) {
 sim_value_t sim_algo_rapid_linear_decay(sim_field_t* field, float current_time) {
     sim_value_t result = {0};
     
-    if (!field || !field->params) return result;
+    if (!field) return result;
     
     // Get parameters
-    static float start_val = 0.0f; 
-
     if(!field->rapid_algo_initialized) {
-        start_val = field->current_value.f; 
+        field->rapid_start_value = field->current_value.f; 
         field->rapid_algo_initialized = true;
     }
+    float start_val = field->rapid_start_value;
 
-    cJSON* end_value = cJSON_GetObjectItem(field->params, "end_value");
-    cJSON* rapid_duration = cJSON_GetObjectItem(field->params, "rapid_duration_seconds");
-
-    float end_val = end_value && cJSON_IsNumber(end_value) ? (float)cJSON_GetNumberValue(end_value) : 0.0f;
-    float rapid_duration_sec = rapid_duration && cJSON_IsNumber(rapid_duration) ? (float)cJSON_GetNumberValue(rapid_duration) : 1.0f;
+    float end_val = field->params.rapid_linear_decay.end_value;
+    float rapid_duration_sec = field->params.rapid_linear_decay.duration_seconds;
     
     // Calculate current progress (0.0 to 1.0)
     float elapsed_time = current_time - field->start_time;
@@ -124,19 +111,16 @@ sim_value_t sim_algo_rapid_linear_decay(sim_field_t* field, float current_time)
 sim_value_t sim_algo_rapid_linear_growth(sim_field_t* field, float current_time) {
     sim_value_t result = {0};
     
-    if (!field || !field->params) return result;
+    if (!field) return result;
     
     // Get parameters
-    static float start_val = 0.0f; 
-
     if(!field->rapid_algo_initialized) {
-        start_val = field->current_value.f; 
+        field->rapid_start_value = field->current_value.f; 
         field->rapid_algo_initialized = true;
     }
+    float start_val = field->rapid_start_value;
 
-    cJSON* rapid_growth_rate = cJSON_GetObjectItem(field->params, "rapid_growth_rate");
-
-    float rapid_rate = rapid_growth_rate && cJSON_IsNumber(rapid_growth_rate) ? (float)cJSON_GetNumberValue(rapid_growth_rate) : 1.0f;
+    float rapid_rate = field->params.rapid_linear_growth.growth_rate;
 
 
     // Calculate current value based on growth rate
@@ -161,16 +145,12 @@ sim_value_t sim_algo_rapid_linear_growth(sim_field_t* field, float current_time)
 sim_value_t sim_algo_linear_growth(sim_field_t* field, float current_time) {
     sim_value_t result = {0};
     
-    if (!field || !field->params) return result;
+    if (!field) return result;
     
     // Get parameters
-    cJSON* start_value = cJSON_GetObjectItem(field->params, "start_value");
-    cJSON* growth_rate = cJSON_GetObjectItem(field->params, "growth_rate");
-    cJSON* max_value = cJSON_GetObjectItem(field->params, "max_value");
-    
-    float start_val = start_value && cJSON_IsNumber(start_value) ? (float)cJSON_GetNumberValue(start_value) : 0.0f;
-    float rate = growth_rate && cJSON_IsNumber(growth_rate) ? (float)cJSON_GetNumberValue(growth_rate) : 1.0f;
-    float max_val = max_value && cJSON_IsNumber(max_value) ? (float)cJSON_GetNumberValue(max_value) : INFINITY;
+    float start_val = field->params.linear_growth.start_value;
+    float rate = field->params.linear_growth.growth_rate;
+    float max_val = field->params.linear_growth.max_value;
     
     // Calculate current value based on growth rate
     float elapsed_time = current_time - field->start_time;
@@ -197,15 +177,11 @@ sim_value_t sim_algo_linear_growth(sim_field_t* field, float current_time) {
 sim_value_t sim_algo_linear_growth_constant(sim_field_t* field, float current_time) {
     sim_value_t result = {0};
     
-    if (!field || !field->params) return result;
+    if (!field) return result;
     
     // Get parameters
-    cJSON* growth_rate = cJSON_GetObjectItem(field->params, "growth_rate");
-    cJSON* max_value = cJSON_GetObjectItem(field->params, "end_value_constant_growth");
-
-    
-    float rate = growth_rate && cJSON_IsNumber(growth_rate) ? (float)cJSON_GetNumberValue(growth_rate) : 1.0f;
-    float max_val = max_value && cJSON_IsNumber(max_value) ? (float)cJSON_GetNumberValue(max_value) : INFINITY;
+    float rate = field->params.linear_growth_constant.growth_rate;
+    float max_val = field->params.linear_growth_constant.end_value;
     
     // Calculate current value based on growth rate
     float current_value = field->current_value.f + (rate);
@@ -230,14 +206,11 @@ sim_value_t sim_algo_linear_growth_constant(sim_field_t* field, float current_ti
 sim_value_t sim_algo_linear_decay_constant(sim_field_t* field, float current_time) {
     sim_value_t result = {0};
     
-    if (!field || !field->params) return result;
+    if (!field) return result;
     
     // Get parameters
-    cJSON* decay_rate = cJSON_GetObjectItem(field->params, "decay_rate");
-    cJSON* end_value = cJSON_GetObjectItem(field->params, "end_value_constant_decay");
-    
-    float rate = decay_rate && cJSON_IsNumber(decay_rate) ? (float)cJSON_GetNumberValue(decay_rate) : 1.0f;
-    float end_val = end_value && cJSON_IsNumber(end_value) ? (float)cJSON_GetNumberValue(end_value) : -INFINITY;
+    float rate = field->params.linear_decay_constant.decay_rate;
+    float end_val = field->params.linear_decay_constant.end_value;
     
     // Calculate current value based on decay rate
     float elapsed_time = current_time - field->start_time;
@@ -265,17 +238,15 @@ sim_value_t sim_algo_linear_decay_constant(sim_field_t* field, float current_tim
 sim_value_t sim_algo_dependent_value(sim_field_t* field, float current_time, sim_engine_t* engine) {
     sim_value_t result = {0};
     
-    if (!field || !field->params || !engine) return result;
+    if (!field || !engine) return result;
     
-    // Get formula parameter
-    cJSON* formula = cJSON_GetObjectItem(field->params, "formula");
-    if (!formula || !cJSON_IsString(formula)) {
+    // Formula is compiled by sim_engine_initialize
+    if (!field->params.dependent_value.formula) {
         printf("Warning: No formula specified for dependent field %s\n", field->field_name);
         return result;
     }
     
-    const char* formula_str = cJSON_GetStringValue(formula);
-    float calculated_value = sim_algo_evaluate_formula(formula_str, engine);
+    float calculated_value = sim_algo_evaluate_formula(&field->formula);
 
     result.f = calculated_value;
 
@@ -284,9 +255,28 @@ sim_value_t sim_algo_dependent_value(sim_field_t* field, float current_time, sim
 
 
 
+/**
+ * Binds an external_value field to a handle from engine->bind_external_value, so the source path is only
+ * resolved once instead of on every update.
+ *
+ * @param field Pointer to the field containing algorithm parameters
+ * @param engine Pointer to the simulation engine
+ * @return true if the field now has a valid handle
+ */
+bool sim_algo_bind_external_value(sim_field_t* field, sim_engine_t* engine) {
+    if (!field || !engine || !engine->bind_external_value) return false;
+
+    const char* file_path = field->params.external_value.file_path;
+    const char* field_path = field->params.external_value.field_path;
+    if (!file_path || !field_path) return false;
+
+    field->external_handle = engine->bind_external_value(file_path, field_path);
+    return field->external_handle >= 0;
+}
+
 /**
  * External value algorithm for fetching values from data JSON files.
- * Reads the specified field from data/{file_path}.
+ * Reads the specified field through the field's bound handle, or from data/{file_path} if no reader is set.
  *
  * @param field Pointer to the field containing algorithm parameters
  * @param current_time Current simulation time (unused for external values)
@@ -296,24 +286,39 @@ sim_value_t sim_algo_dependent_value(sim_field_t* field, float current_time, sim
 sim_value_t sim_algo_external_value(sim_field_t* field, float current_time, sim_engine_t* engine) {
     sim_value_t result = {0};
 
-    if (!field || !field->params || !engine) return result;
+    if (!field || !engine) return result;
+
+    // Bound fields read straight through their handle
+    if (engine->read_external_value && field->external_handle >= 0) {
+        if (!engine->read_external_value(field->external_handle, &result.f)) {
+            printf("Warning: External value for field %s is not a number or boolean\n", field->field_name);
+        }
+        return result;
+    }
 
     // Get parameters
-    cJSON* file_path_param = cJSON_GetObjectItem(field->params, "file_path");
-    cJSON* field_path_param = cJSON_GetObjectItem(field->params, "field_path");
+    const char* file_path = field->params.external_value.file_path;
+    const char* field_path = field->params.external_value.field_path;
 
-    if (!file_path_param || !cJSON_IsString(file_path_param)) {
+    if (!file_path) {
         printf("Warning: No file_path specified for external_value field %s\n", field->field_name);
         return result;
     }
 
-    if (!field_path_param || !cJSON_IsString(field_path_param)) {
+    if (!field_path) {
         printf("Warning: No field_path specified for external_value field %s\n", field->field_name);
         return result;
     }
 
-    const char* file_path = cJSON_GetStringValue(file_path_param);
-    const char* field_path = cJSON_GetStringValue(field_path_param);
+    // Prefer the engine's in-memory data source when one has been provided
+    if (engine->read_external_value) {
+        if (!sim_algo_bind_external_value(field, engine)) {
+            printf("Warning: Could not find field '%s' in %s\n", field_path, file_path);
+        } else if (!engine->read_external_value(field->external_handle, &result.f)) {
+            printf("Warning: Field '%s' in %s is not a number or boolean\n", field_path, file_path);
+        }
+        return result;
+    }
 
     // Construct full file path: data/{file_path}
     char full_path[512];
@@ -481,69 +486,61 @@ static int get_precedence(char op) {
 }
 
 /**
- * Applies a binary operator to two operands
+ * Returns the instruction that applies a binary operator.
  *
  * @param op Operator character (+, -, *, /)
- * @param a Left operand
- * @param b Right operand
- * @return Result of applying operator to operands
+ * @return Opcode of the operator
  */
-static float apply_operator(char op, float a, float b) {
+static sim_formula_opcode_t operator_opcode(char op) {
     switch(op) {
         case '+':
-            return a + b;
+            return SIM_FORMULA_ADD;
         case '-':
-            return a - b;
+            return SIM_FORMULA_SUBTRACT;
         case '*':
-            return a * b;
-        case '/':
-            return (b != 0.0f) ? a / b : 0.0f;
+            return SIM_FORMULA_MULTIPLY;
         default:
-            return 0.0f;
+            return SIM_FORMULA_DIVIDE;
     }
 }
 
 /**
- * Parses a token as either a numeric literal or field name lookup
- *
- * @param token Token string to parse
- * @param engine Simulation engine for field value lookup
- * @return Numeric value of token
- */
-static float parse_token_value(const char* token, sim_engine_t* engine) {
-    if (isdigit(token[0]) || (token[0] == '-' && isdigit(token[1]))) {
-        return atof(token);
-    }
-    sim_value_t field_value = sim_engine_get_field_value(engine, token);
-    return field_value.f;
-}
-
-/**
- * Evaluates a mathematical formula string using current field values.
- * Supports arithmetic operations (+, -, *, /) and parentheses.
+ * Compiles a formula string into postfix instructions.
+ * Supports arithmetic operations (+, -, *, /) and parentheses, tokens are separated by spaces.
  * Implements proper operator precedence (* / before + -) and parentheses grouping.
- * Example: "90.0 + (temperature - 21.1) * 0.36"
+ * Field names are resolved here the same way sim_engine_get_field_value finds them, unknown names read as 0.
+ * Example: "90.0 + ( temperature - 21.1 ) * 0.36"
  *
- * @param formula String containing the mathematical formula to evaluate
- * @param engine Pointer to the simulation engine for field value lookup
- * @return Calculated result of the formula evaluation
+ * @param formula Compiled formula to fill in, replaces any instructions it already has
+ * @param source String containing the mathematical formula to compile
+ * @param engine Pointer to the simulation engine for field lookup
+ * @return true if the formula was compiled, false if it nests deeper than SIM_FORMULA_MAX_DEPTH
  */
-float sim_algo_evaluate_formula(const char* formula, sim_engine_t* engine) {
-    if (!formula || !engine) return 0.0f;
+bool sim_algo_compile_formula(sim_formula_t* formula, const char* source, sim_engine_t* engine) {
+    if (!formula) return false;
+
+    free(formula->code);
+    formula->code = NULL;
+    formula->length = 0;
 
-    // Stacks for two-stack algorithm
-    float value_stack[64];
-    int value_top = -1;
+    if (!source || !engine) return false;
 
-    char op_stack[64];
+    // Tokens are separated by spaces, so there are never more of them than half the characters
+    int capacity = (int)strlen(source) / 2 + 1;
+    sim_formula_instruction_t* code = calloc(capacity, sizeof(sim_formula_instruction_t));
+    int length = 0;
+
+    // Shunting-yard, depth tracks how many values the emitted instructions leave on the stack
+    char op_stack[SIM_FORMULA_MAX_DEPTH];
     int op_top = -1;
+    int depth = 0;
+    bool valid = true;
 
-    // Tokenize and process
-    char* formula_copy = strdup(formula);
+    char* source_copy = strdup(source);
     char* token;
-    char* rest = formula_copy;
+    char* rest = source_copy;
 
-    while ((token = strtok_r(rest, " ", &rest))) {
+    while (valid && (token = strtok_r(rest, " ", &rest))) {
         // Skip commas
         if (strcmp(token, ",") == 0) {
             continue;
@@ -551,6 +548,10 @@ float sim_algo_evaluate_formula(const char* formula, sim_engine_t* engine) {
 
         // Handle opening parenthesis
         if (token[0] == '(' && token[1] == '\0') {
+            if (op_top + 1 >= SIM_FORMULA_MAX_DEPTH) {
+                valid = false;
+                break;
+            }
             op_stack[++op_top] = '(';
             continue;
         }
@@ -560,10 +561,9 @@ float sim_algo_evaluate_formula(const char* formula, sim_engine_t* engine) {
             // Pop operators until '('
             while (op_top >= 0 && op_stack[op_top] != '(') {
                 char op = op_stack[op_top--];
-                if (value_top < 1) break;  // Safety check
-                float b = value_stack[value_top--];
-                float a = value_stack[value_top--];
-                value_stack[++value_top] = apply_operator(op, a, b);
+                if (depth < 2) break;  // Safety check
+                code[length++].opcode = operator_opcode(op);
+                depth--;
             }
 
             // Remove '(' from stack
@@ -582,33 +582,106 @@ float sim_algo_evaluate_formula(const char* formula, sim_engine_t* engine) {
             while (op_top >= 0 && op_stack[op_top] != '(' &&
                    get_precedence(op_stack[op_top]) >= prec) {
                 char prev_op = op_stack[op_top--];
-                if (value_top < 1) break;  // Safety check
-                float b = value_stack[value_top--];
-                float a = value_stack[value_top--];
-                value_stack[++value_top] = apply_operator(prev_op, a, b);
+                if (depth < 2) break;  // Safety check
+                code[length++].opcode = operator_opcode(prev_op);
+                depth--;
             }
 
+            if (op_top + 1 >= SIM_FORMULA_MAX_DEPTH) {
+                valid = false;
+                break;
+            }
             op_stack[++op_top] = op;
             continue;
         }
 
         // Handle numbers and field names
-        float value = parse_token_value(token, engine);
-        value_stack[++value_top] = value;
+        if (depth + 1 > SIM_FORMULA_MAX_DEPTH) {
+            valid = false;
+            break;
+        }
+
+        sim_formula_instruction_t* instruction = &code[length++];
+        if (isdigit((unsigned char)token[0]) || (token[0] == '-' && isdigit((unsigned char)token[1]))) {
+            instruction->opcode = SIM_FORMULA_CONSTANT;
+            instruction->constant = atof(token);
+        } else {
+            sim_field_t* field = sim_engine_find_field(engine, token);
+            if (field) {
+                instruction->opcode = SIM_FORMULA_FIELD;
+                instruction->value = &field->current_value;
+            } else {
+                printf("Warning: Unknown field '%s' in formula \"%s\", using 0\n", token, source);
+                instruction->opcode = SIM_FORMULA_CONSTANT;
+                instruction->constant = 0.0f;
+            }
+        }
+        depth++;
     }
 
     // Pop remaining operators
-    while (op_top >= 0) {
+    while (valid && op_top >= 0) {
         char op = op_stack[op_top--];
         if (op == '(') continue;  // Skip unmatched parens
-        if (value_top < 1) break;  // Safety check
-        float b = value_stack[value_top--];
-        float a = value_stack[value_top--];
-        value_stack[++value_top] = apply_operator(op, a, b);
+        if (depth < 2) break;  // Safety check
+        code[length++].opcode = operator_opcode(op);
+        depth--;
+    }
+
+    free(source_copy);
+
+    if (!valid) {
+        printf("Error: Formula \"%s\" nests deeper than %d values or operators\n", source, SIM_FORMULA_MAX_DEPTH);
+        free(code);
+        return false;
+    }
+
+    formula->code = code;
+    formula->length = length;
+    return true;
+}
+
+/**
+ * Evaluates a compiled formula using current field values.
+ *
+ * @param formula Formula compiled by sim_algo_compile_formula
+ * @return Calculated result of the formula, 0 if it is empty
+ */
+float sim_algo_evaluate_formula(const sim_formula_t* formula) {
+    if (!formula) return 0.0f;
+
+    float stack[SIM_FORMULA_MAX_DEPTH];
+    int top = -1;
+
+    for (int i = 0; i < formula->length; i++) {
+        const sim_formula_instruction_t* instruction = &formula->code[i];
+        switch (instruction->opcode) {
+            case SIM_FORMULA_CONSTANT:
+                stack[++top] = instruction->constant;
+                break;
+            case SIM_FORMULA_FIELD:
+                stack[++top] = instruction->value->f;
+                break;
+            case SIM_FORMULA_ADD:
+                top--;
+                stack[top] = stack[top] + stack[top + 1];
+                break;
+            case SIM_FORMULA_SUBTRACT:
+                top--;
+                stack[top] = stack[top] - stack[top + 1];
+                break;
+            case SIM_FORMULA_MULTIPLY:
+                top--;
+                stack[top] = stack[top] * stack[top + 1];
+                break;
+            case SIM_FORMULA_DIVIDE:
+                top--;
+                stack[top] = (stack[top + 1] != 0.0f) ? stack[top] / stack[top + 1] : 0.0f;
+                break;
+        }
     }
 
-    free(formula_copy);
-    return value_top >= 0 ? value_stack[value_top] : 0.0f;
+    return top >= 0 ? stack[top] : 0.0f;
 }
 
 /**
@@ -25,7 +25,9 @@ bool sim_algo_validate_linear_growth_params(cJSON* params);
 bool sim_algo_validate_dependent_value_params(cJSON* params);
 
 // Utility functions
-float sim_algo_evaluate_formula(const char* formula, sim_engine_t* engine);
+bool sim_algo_bind_external_value(sim_field_t* field, sim_engine_t* engine);
+bool sim_algo_compile_formula(sim_formula_t* formula, const char* source, sim_engine_t* engine);
+float sim_algo_evaluate_formula(const sim_formula_t* formula);
 sim_algorithm_type_t sim_algo_parse_type_string(const char* algo_string);
 const char* sim_algo_type_to_string(sim_algorithm_type_t type);
 
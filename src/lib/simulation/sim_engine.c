@@ -48,9 +48,11 @@ void sim_engine_destroy(sim_engine_t* engine) {
             free(field->field_name);
             free(field->component_name);
             
-            if (field->params) {
-                cJSON_Delete(field->params);
-            }
+            free(field->params.dependent_value.formula);
+            free(field->params.external_value.file_path);
+            free(field->params.external_value.field_path);
+            free(field->params.external_value.reset_value);
+            free(field->formula.code);
             
             // Free dependency array
             for (int k = 0; k < field->depends_count; k++) {
@@ -113,6 +115,122 @@ bool sim_engine_load_predefined_configs(sim_engine_t* engine) {
     return success;
 }
 
+/**
+ * Reads a numeric parameter from a field's config entry.
+ *
+ * @param field_json JSON object of the field
+ * @param name Parameter name
+ * @param default_value Value used when the parameter is missing or not a number
+ * @return The parameter value
+ */
+static float parse_number_param(cJSON* field_json, const char* name, float default_value) {
+    cJSON* param = cJSON_GetObjectItem(field_json, name);
+    return param && cJSON_IsNumber(param) ? (float)cJSON_GetNumberValue(param) : default_value;
+}
+
+/**
+ * Copies a string parameter from a field's config entry.
+ *
+ * @param field_json JSON object of the field
+ * @param name Parameter name
+ * @return Allocated copy of the string, NULL if the parameter is missing or not a string
+ */
+static char* parse_string_param(cJSON* field_json, const char* name) {
+    cJSON* param = cJSON_GetObjectItem(field_json, name);
+    return param && cJSON_IsString(param) ? strdup(cJSON_GetStringValue(param)) : NULL;
+}
+
+/**
+ * Parses the parameters of every algorithm from a field's config entry, applying the algorithm defaults
+ * for anything the entry leaves out.
+ *
+ * @param params Parameters to fill in
+ * @param field_json JSON object of the field
+ */
+static void parse_field_params(sim_field_params_t* params, cJSON* field_json) {
+    params->sine_wave.base_value = parse_number_param(field_json, "base_value", 0.0f);
+    params->sine_wave.amplitude = parse_number_param(field_json, "amplitude", 1.0f);
+    params->sine_wave.frequency = parse_number_param(field_json, "frequency", 1.0f);
+    params->sine_wave.phase_offset = parse_number_param(field_json, "phase_offset", 0.0f);
+
+    params->linear_decay.start_value = parse_number_param(field_json, "start_value", 100.0f);
+    params->linear_decay.end_value = parse_number_param(field_json, "end_value", 0.0f);
+    params->linear_decay.duration_seconds = parse_number_param(field_json, "duration_seconds", 1.0f);
+
+    params->rapid_linear_decay.end_value = parse_number_param(field_json, "end_value", 0.0f);
+    params->rapid_linear_decay.duration_seconds = parse_number_param(field_json, "rapid_duration_seconds", 1.0f);
+
+    params->rapid_linear_growth.growth_rate = parse_number_param(field_json, "rapid_growth_rate", 1.0f);
+
+    params->linear_growth.start_value = parse_number_param(field_json, "start_value", 0.0f);
+    params->linear_growth.growth_rate = parse_number_param(field_json, "growth_rate", 1.0f);
+    params->linear_growth.max_value = parse_number_param(field_json, "max_value", INFINITY);
+
+    params->linear_growth_constant.growth_rate = parse_number_param(field_json, "growth_rate", 1.0f);
+    params->linear_growth_constant.end_value = parse_number_param(field_json, "end_value_constant_growth", INFINITY);
+
+    params->linear_decay_constant.decay_rate = parse_number_param(field_json, "decay_rate", 1.0f);
+    params->linear_decay_constant.end_value = parse_number_param(field_json, "end_value_constant_decay", -INFINITY);
+
+    params->dependent_value.formula = parse_string_param(field_json, "formula");
+
+    params->external_value.file_path = parse_string_param(field_json, "file_path");
+    params->external_value.field_path = parse_string_param(field_json, "field_path");
+
+    // Keep the reset value in the string form the data file update expects
+    cJSON* reset_value = cJSON_GetObjectItem(field_json, "reset_value");
+    char value_str[256];
+    params->external_value.reset_value = NULL;
+    if (cJSON_IsBool(reset_value)) {
+        snprintf(value_str, sizeof(value_str), "%s", cJSON_IsTrue(reset_value) ? "true" : "false");
+        params->external_value.reset_value = strdup(value_str);
+    } else if (cJSON_IsNumber(reset_value)) {
+        snprintf(value_str, sizeof(value_str), "%g", reset_value->valuedouble);
+        params->external_value.reset_value = strdup(value_str);
+    } else if (cJSON_IsString(reset_value)) {
+        params->external_value.reset_value = strdup(reset_value->valuestring);
+    }
+
+    cJSON* base_value = cJSON_GetObjectItem(field_json, "base_value");
+    cJSON* start_value = cJSON_GetObjectItem(field_json, "start_value");
+    params->has_base_value = base_value && cJSON_IsNumber(base_value);
+    params->has_start_value = start_value && cJSON_IsNumber(start_value);
+    params->start_value = params->has_start_value ? (float)cJSON_GetNumberValue(start_value) : 0.0f;
+}
+
+/**
+ * Finds the DCU switch a field depends on from its name.
+ *
+ * @param field_name Name of the field
+ * @return The field's DCU gate, SIM_DCU_GATE_NONE if it updates regardless of the DCU
+ */
+static sim_dcu_gate_t dcu_gate_for_field(const char* field_name) {
+    if (strncmp(field_name, "primary_battery_level", 21) == 0) return SIM_DCU_GATE_PRIMARY_BATTERY;
+    if (strncmp(field_name, "secondary_battery_level", 23) == 0) return SIM_DCU_GATE_SECONDARY_BATTERY;
+    if (strncmp(field_name, "oxy_pri_storage", 15) == 0) return SIM_DCU_GATE_OXY_PRIMARY;
+    if (strncmp(field_name, "oxy_sec_storage", 15) == 0) return SIM_DCU_GATE_OXY_SECONDARY;
+    if (strncmp(field_name, "fan_pri_rpm", 11) == 0) return SIM_DCU_GATE_FAN_PRIMARY;
+    if (strncmp(field_name, "fan_sec_rpm", 11) == 0) return SIM_DCU_GATE_FAN_SECONDARY;
+    if (strncmp(field_name, "coolant_liquid_pressure", 23) == 0) return SIM_DCU_GATE_PUMP;
+    return SIM_DCU_GATE_NONE;
+}
+
+/**
+ * Finds the errors that keep a field active regardless of its DCU gate.
+ *
+ * @param field_name Name of the field
+ * @return Bit mask with bit n set for error type n
+ */
+static unsigned int error_mask_for_field(const char* field_name) {
+    if (strcmp(field_name, "oxy_pri_storage") == 0) {
+        return (1u << SUIT_PRESSURE_OXY_LOW) | (1u << SUIT_PRESSURE_OXY_HIGH);
+    }
+    if (strcmp(field_name, "fan_pri_rpm") == 0) {
+        return (1u << FAN_RPM_HIGH) | (1u << FAN_RPM_LOW);
+    }
+    return 0;
+}
+
 /**
  * Loads a single JSON simulation component configuration file.
  * Parses the JSON and adds the component and its fields to the engine.
@@ -210,8 +328,8 @@ bool sim_engine_load_component(sim_engine_t* engine, const char* json_file_path)
         // Parse type (always float)
         field->type = SIM_TYPE_FLOAT;
         
-        // Clone parameters for algorithm use
-        field->params = cJSON_Duplicate(field_json, true);
+        // Parse parameters once so updates never touch the JSON
+        parse_field_params(&field->params, field_json);
         
         // Parse dependencies
         cJSON* depends_on = cJSON_GetObjectItem(field_json, "depends_on");
@@ -234,6 +352,10 @@ bool sim_engine_load_component(sim_engine_t* engine, const char* json_file_path)
         field->active = true; //active by default, can be deactivated by DCU commands for certain fields
         field->rapid_algo_initialized = false;
         field->initialized = false;
+        field->external_handle = -1;
+        field->component_index = engine->component_count;
+        field->dcu_gate = dcu_gate_for_field(field->field_name);
+        field->error_mask = error_mask_for_field(field->field_name);
         field_idx++;
     }
     
@@ -335,6 +457,23 @@ static bool sort_fields_by_dependencies(sim_engine_t* engine) {
 //                           Simulation Control
 ///////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Works out which DCU gates are open for the current DCU switch positions.
+ *
+ * @param settings Current DCU switch positions
+ * @param gate_open Set to whether fields with each gate should update
+ */
+static void get_open_dcu_gates(const sim_DCU_field_settings_t* settings, bool gate_open[SIM_DCU_GATE_COUNT]) {
+    gate_open[SIM_DCU_GATE_NONE] = true;
+    gate_open[SIM_DCU_GATE_PRIMARY_BATTERY] = !settings->battery_lu && settings->battery_ps;
+    gate_open[SIM_DCU_GATE_SECONDARY_BATTERY] = !settings->battery_lu && !settings->battery_ps;
+    gate_open[SIM_DCU_GATE_OXY_PRIMARY] = settings->o2;
+    gate_open[SIM_DCU_GATE_OXY_SECONDARY] = !settings->o2;
+    gate_open[SIM_DCU_GATE_FAN_PRIMARY] = settings->fan;
+    gate_open[SIM_DCU_GATE_FAN_SECONDARY] = !settings->fan;
+    gate_open[SIM_DCU_GATE_PUMP] = settings->pump;
+}
+
 /**
  * Initializes the simulation engine after all components have been loaded.
  * Sorts fields by dependencies, sets initial values, and prepares for simulation.
@@ -366,94 +505,48 @@ bool sim_engine_initialize(sim_engine_t* engine) {
         engine->time_to_complete_task_board = 0;
         engine->error_type = NUM_ERRORS; // set to NUM_ERRORS to signify no error, will be set to 0,1,2..NUM_ERRORS-1 to signify different errors when it's time to throw an error
     
+    bool gate_open[SIM_DCU_GATE_COUNT];
+    get_open_dcu_gates(engine->dcu_field_settings, gate_open);
+
     // Initialize all fields
     for (int i = 0; i < engine->total_field_count; i++) {
         sim_field_t* field = engine->update_order[i];
 
-        // Find the component this field belongs to and use its simulation time
-        sim_component_t* component = NULL;
-        for (int j = 0; j < engine->component_count; j++) {
-            if (strcmp(engine->components[j].component_name, field->component_name) == 0) {
-                component = &engine->components[j];
-                break;
-            }
-        }
-
-        field->start_time = component ? component->simulation_time : 0.0f;
+        // Use the simulation time of the component this field belongs to
+        field->start_time = engine->components[field->component_index].simulation_time;
 
         field->run_time = 0.0f;
 
-        
-        
-        //set active to true by default, will be set to false for fields that depend on DCU commands until the correct command is received
-        if(strncmp(field->field_name, "primary_battery_level", 21) == 0 && !(engine->dcu_field_settings->battery_lu == false && engine->dcu_field_settings->battery_ps == true)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "secondary_battery_level", 23) == 0 && !(engine->dcu_field_settings->battery_lu == false && engine->dcu_field_settings->battery_ps == false)) {
-            field->active = false;
-        }
-
-        if(strncmp(field->field_name, "oxy_pri_storage", 15) == 0 && (engine->dcu_field_settings->o2 == false)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "oxy_sec_storage", 15) == 0 && (engine->dcu_field_settings->o2 == true)) {
-            field->active = false;
-        }
-
-        if(strncmp(field->field_name, "fan_pri_rpm", 11) == 0 && (engine->dcu_field_settings->fan == false)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "fan_sec_rpm", 11) == 0 && (engine->dcu_field_settings->fan == true)) {
-            field->active = false;
-        }
-
-        if(strncmp(field->field_name, "coolant_liquid_pressure", 23) == 0 && (engine->dcu_field_settings->pump == false)) {
-            field->active = false;
+        // Compile the formula now that every field it can reference is loaded
+        if (field->params.dependent_value.formula) {
+            sim_algo_compile_formula(&field->formula, field->params.dependent_value.formula, engine);
         }
 
-        if(strncmp(field->field_name, "scrubber_a_co2_storage", 22) == 0 && (engine->dcu_field_settings->co2 == false)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "scrubber_b_co2_storage", 22) == 0 && (engine->dcu_field_settings->co2 == true)) {
-            field->active = false;
-        }
         
+        
+        //fields that depend on DCU commands stay inactive until the correct command is received
+        field->active = gate_open[field->dcu_gate];
 
         field->initialized = true;
         
         // Set initial values based on algorithm
         switch (field->algorithm) {
             case SIM_ALGO_SINE_WAVE: {
-                cJSON* base_value = cJSON_GetObjectItem(field->params, "base_value");
-                if (base_value && cJSON_IsNumber(base_value)) {
-                    field->current_value.f = (float)cJSON_GetNumberValue(base_value);
-                }
-                break;
-            }
-            case SIM_ALGO_LINEAR_DECAY: {
-                cJSON* start_value = cJSON_GetObjectItem(field->params, "start_value");
-                if (start_value && cJSON_IsNumber(start_value)) {
-                    field->current_value.f = (float)cJSON_GetNumberValue(start_value);
-                }
-                break;
-            }
-            case SIM_ALGO_LINEAR_DECAY_CONSTANT: {
-                cJSON* start_value = cJSON_GetObjectItem(field->params, "start_value");
-                if (start_value && cJSON_IsNumber(start_value)) {
-                    field->current_value.f = (float)cJSON_GetNumberValue(start_value);
+                if (field->params.has_base_value) {
+                    field->current_value.f = field->params.sine_wave.base_value;
                 }
                 break;
             }
+            case SIM_ALGO_LINEAR_DECAY:
+            case SIM_ALGO_LINEAR_DECAY_CONSTANT:
             case SIM_ALGO_LINEAR_GROWTH_CONSTANT: {
-                cJSON* start_value = cJSON_GetObjectItem(field->params, "start_value");
-                if (start_value && cJSON_IsNumber(start_value)) {
-                    field->current_value.f = (float)cJSON_GetNumberValue(start_value);
+                if (field->params.has_start_value) {
+                    field->current_value.f = field->params.start_value;
                 }
                 break;
             }
             case SIM_ALGO_LINEAR_GROWTH: {
-                cJSON* start_value = cJSON_GetObjectItem(field->params, "start_value");
-                if (start_value && cJSON_IsNumber(start_value)) {
-                    field->current_value.f = (float)cJSON_GetNumberValue(start_value);
-                } else {
-                    field->current_value.f = 0.0f;
-                }
+                field->current_value.f = field->params.linear_growth.start_value;
                 break;
             }
             case SIM_ALGO_DEPENDENT_VALUE: {
@@ -462,10 +555,14 @@ bool sim_engine_initialize(sim_engine_t* engine) {
                 break;
             }
             case SIM_ALGO_EXTERNAL_VALUE: {
-                // Will be calculated during first update
+                // Will be calculated during first update, bind the source path now so updates skip the lookup
                 field->current_value.f = 0.0f;
+                sim_algo_bind_external_value(field, engine);
                 break;
             }
+            default:
+                // The rapid algorithms keep the value the field was loaded with
+                break;
         }
         
         field->previous_value = field->current_value;
@@ -495,57 +592,21 @@ void sim_engine_update(sim_engine_t* engine, float delta_time) {
         }
     }
 
-    //Next, advance simulation time for all fields that are running
-    for(int i = 0; i < engine->total_field_count; i++) {
-        sim_field_t* field = engine->update_order[i];
+    //Next, advance simulation time for all fields that are running and active
+    bool gate_open[SIM_DCU_GATE_COUNT];
+    get_open_dcu_gates(engine->dcu_field_settings, gate_open);
 
-        // Find the component this field belongs to
-        sim_component_t* component = NULL;
-        for (int j = 0; j < engine->component_count; j++) {
-            if (strcmp(engine->components[j].component_name, field->component_name) == 0) {
-                component = &engine->components[j];
-                break;
-            }
-        }
+    //an active error keeps its fields active regardless of DCU settings
+    unsigned int error_bit = (engine->error_type >= 0 && engine->error_type < NUM_ERRORS) ? 1u << engine->error_type : 0;
 
-        
-        
-        //set active to true by default, will be set to false for fields that depend on DCU commands until the correct command is received
-        if(strncmp(field->field_name, "primary_battery_level", 21) == 0 && !(engine->dcu_field_settings->battery_lu == false && engine->dcu_field_settings->battery_ps == true)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "secondary_battery_level", 23) == 0 && !(engine->dcu_field_settings->battery_lu == false && engine->dcu_field_settings->battery_ps == false)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "oxy_pri_storage", 15) == 0 && (engine->dcu_field_settings->o2 == false)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "oxy_sec_storage", 15) == 0 && (engine->dcu_field_settings->o2 == true)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "fan_pri_rpm", 11) == 0 && (engine->dcu_field_settings->fan == false)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "fan_sec_rpm", 11) == 0 && (engine->dcu_field_settings->fan == true)) {
-            field->active = false;
-        } else if(strncmp(field->field_name, "coolant_liquid_pressure", 23) == 0 && (engine->dcu_field_settings->pump == false)) {
-            field->active = false;
-        } else {
-            field->active = true;
-        }
+    for(int i = 0; i < engine->total_field_count; i++) {
+        sim_field_t* field = engine->update_order[i];
 
-        //error overrides active status, so if an error is active for a field, it should be active regardless of DCU settings
-        if((engine->error_type == SUIT_PRESSURE_OXY_LOW) && (strcmp(field->field_name, "oxy_pri_storage") == 0)) {
-            field->active = true;
-        } else if((engine->error_type == SUIT_PRESSURE_OXY_HIGH) && (strcmp(field->field_name, "oxy_pri_storage") == 0)) {
-            field->active = true;
-        } else if((engine->error_type == FAN_RPM_HIGH) && (strcmp(field->field_name, "fan_pri_rpm") == 0)) {
-            field->active = true;
-        } else if((engine->error_type == FAN_RPM_LOW) && (strcmp(field->field_name, "fan_pri_rpm") == 0)) {
-            field->active = true;
-        }
+        field->active = gate_open[field->dcu_gate] || (field->error_mask & error_bit) != 0;
 
-        
         // Only update run_time if component is running
-        if (component && component->running && field->active) {
-            field->run_time += delta_time;
-        }
-            
+        bool running = engine->components[field->component_index].running;
+        field->run_time += (running && field->active) ? delta_time : 0.0f;
     }
     
     //determine if we need to throw additional errors
@@ -569,17 +630,7 @@ void sim_engine_update(sim_engine_t* engine, float delta_time) {
     for (int i = 0; i < engine->total_field_count; i++) {
         sim_field_t* field = engine->update_order[i];
 
-        // Find the component this field belongs to
-        sim_component_t* component = NULL;
-        for (int j = 0; j < engine->component_count; j++) {
-            if (strcmp(engine->components[j].component_name, field->component_name) == 0) {
-                component = &engine->components[j];
-                break;
-            }
-        }
-
-        // Only update if component is running and DCU in correct state (if field depends on DCU commands)
-        if (!component || !component->running) continue;
+        if (!engine->components[field->component_index].running) continue;
 
         field->previous_value = field->current_value;
 
@@ -589,7 +640,6 @@ void sim_engine_update(sim_engine_t* engine, float delta_time) {
                 break;
             case SIM_ALGO_LINEAR_DECAY:
                 field->current_value = sim_algo_linear_decay(field, field->run_time);
-                
                 break;
             case SIM_ALGO_RAPID_LINEAR_DECAY:
                 field->current_value = sim_algo_rapid_linear_decay(field, field->run_time);
@@ -601,7 +651,7 @@ void sim_engine_update(sim_engine_t* engine, float delta_time) {
                 field->current_value = sim_algo_linear_growth(field, field->run_time);
                 break;
             case SIM_ALGO_DEPENDENT_VALUE:
-                field->current_value = sim_algo_dependent_value(field,  field->run_time, engine);
+                field->current_value = sim_algo_dependent_value(field, field->run_time, engine);
                 break;
             case SIM_ALGO_EXTERNAL_VALUE:
                 field->current_value = sim_algo_external_value(field, field->run_time, engine);
@@ -698,7 +748,7 @@ void sim_engine_reset_component(sim_engine_t* engine, const char* component_name
     // Reset all fields of this component
     for (int i = 0; i < engine->total_field_count; i++) {
         sim_field_t* field = engine->update_order[i];
-        if (field && strcmp(field->component_name, component_name) == 0) {
+        if (field && &engine->components[field->component_index] == target_component) {
             // Reset field timing to component time (which is now 0)
             field->start_time = target_component->simulation_time;
             field->run_time = 0.0f; 
@@ -708,28 +758,21 @@ void sim_engine_reset_component(sim_engine_t* engine, const char* component_name
             switch (field->starting_algorithm) {
                 case SIM_ALGO_SINE_WAVE: {
                     field->algorithm = SIM_ALGO_SINE_WAVE; // Reset to original algorithm
-                    cJSON* base_value = cJSON_GetObjectItem(field->params, "base_value");
-                    if (base_value && cJSON_IsNumber(base_value)) {
-                        field->current_value.f = (float)cJSON_GetNumberValue(base_value);
+                    if (field->params.has_base_value) {
+                        field->current_value.f = field->params.sine_wave.base_value;
                     }
                     break;
                 }
                 case SIM_ALGO_LINEAR_DECAY: {
                     field->algorithm = SIM_ALGO_LINEAR_DECAY; // Reset to original algorithm
-                    cJSON* start_value = cJSON_GetObjectItem(field->params, "start_value");
-                    if (start_value && cJSON_IsNumber(start_value)) {
-                        field->current_value.f = (float)cJSON_GetNumberValue(start_value);
+                    if (field->params.has_start_value) {
+                        field->current_value.f = field->params.start_value;
                     }
                     break;
                 }
                 case SIM_ALGO_LINEAR_GROWTH: {
                     field->algorithm = SIM_ALGO_LINEAR_GROWTH; // Reset to original algorithm
-                    cJSON* start_value = cJSON_GetObjectItem(field->params, "start_value");
-                    if (start_value && cJSON_IsNumber(start_value)) {
-                        field->current_value.f = (float)cJSON_GetNumberValue(start_value);
-                    } else {
-                        field->current_value.f = 0.0f;
-                    }
+                    field->current_value.f = field->params.linear_growth.start_value;
                     break;
                 }
                 case SIM_ALGO_DEPENDENT_VALUE: {
@@ -741,16 +784,12 @@ void sim_engine_reset_component(sim_engine_t* engine, const char* component_name
                 case SIM_ALGO_EXTERNAL_VALUE: {
                     field->algorithm = SIM_ALGO_EXTERNAL_VALUE; // Reset to original algorithm
                     // Check if reset_value is defined and update the file if callback is provided
-                    cJSON* reset_value = cJSON_GetObjectItem(field->params, "reset_value");
+                    const char* reset_value = field->params.external_value.reset_value;
                     if (reset_value && update_json) {
-                        cJSON* file_path_param = cJSON_GetObjectItem(field->params, "file_path");
-                        cJSON* field_path_param = cJSON_GetObjectItem(field->params, "field_path");
+                        const char* file_path = field->params.external_value.file_path;
+                        const char* full_field_path = field->params.external_value.field_path;
 
-                        if (file_path_param && cJSON_IsString(file_path_param) &&
-                            field_path_param && cJSON_IsString(field_path_param)) {
-
-                            const char* file_path = cJSON_GetStringValue(file_path_param);
-                            const char* full_field_path = cJSON_GetStringValue(field_path_param);
+                        if (file_path && full_field_path) {
 
                             // Extract filename without extension (e.g., "ROVER.json" -> "ROVER")
                             char filename[64];
@@ -770,19 +809,9 @@ void sim_engine_reset_component(sim_engine_t* engine, const char* component_name
                             char* field_name = strtok(NULL, ".");
 
                             if (section && field_name) {
-                                // Convert reset_value to string
+                                // Pass a copy so the callback can't modify the parsed reset_value
                                 char value_str[256];
-                                if (cJSON_IsBool(reset_value)) {
-                                    snprintf(value_str, sizeof(value_str), "%s",
-                                           reset_value->type == cJSON_True ? "true" : "false");
-                                } else if (cJSON_IsNumber(reset_value)) {
-                                    snprintf(value_str, sizeof(value_str), "%g", reset_value->valuedouble);
-                                } else if (cJSON_IsString(reset_value)) {
-                                    snprintf(value_str, sizeof(value_str), "%s", reset_value->valuestring);
-                                } else {
-                                    field->current_value.f = 0.0f;
-                                    break;
-                                }
+                                snprintf(value_str, sizeof(value_str), "%s", reset_value);
 
                                 // Call the update_json callback
                                 update_json(filename, section, field_name, value_str);
@@ -792,6 +821,9 @@ void sim_engine_reset_component(sim_engine_t* engine, const char* component_name
                     field->current_value.f = 0.0f;
                     break;
                 }
+                default:
+                    // Other starting algorithms keep their current value
+                    break;
             }
 
             field->previous_value = field->current_value;
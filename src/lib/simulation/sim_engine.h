@@ -15,6 +15,7 @@
 #define SIM_DATA_ROOT "data"
 #define SIM_CONFIG_ROOT "src/lib/simulation/config"
 #define INITIAL_NUM_TASK_BOARD_ERRORS 10
+#define SIM_FORMULA_MAX_DEPTH 64 // deepest value or operator stack a dependent_value formula may need
 
 ///////////////////////////////////////////////////////////////////////////////////
 //                                  Data Types
@@ -36,10 +37,96 @@ typedef enum {
     SIM_ALGO_LINEAR_DECAY_CONSTANT
 } sim_algorithm_type_t;
 
+// DCU switch position a field only updates under, decided from the field name when it is loaded
+typedef enum {
+    SIM_DCU_GATE_NONE,
+    SIM_DCU_GATE_PRIMARY_BATTERY,
+    SIM_DCU_GATE_SECONDARY_BATTERY,
+    SIM_DCU_GATE_OXY_PRIMARY,
+    SIM_DCU_GATE_OXY_SECONDARY,
+    SIM_DCU_GATE_FAN_PRIMARY,
+    SIM_DCU_GATE_FAN_SECONDARY,
+    SIM_DCU_GATE_PUMP,
+    SIM_DCU_GATE_COUNT
+} sim_dcu_gate_t;
+
 typedef union {
     float f;
 } sim_value_t;
 
+typedef enum {
+    SIM_FORMULA_CONSTANT,
+    SIM_FORMULA_FIELD,
+    SIM_FORMULA_ADD,
+    SIM_FORMULA_SUBTRACT,
+    SIM_FORMULA_MULTIPLY,
+    SIM_FORMULA_DIVIDE
+} sim_formula_opcode_t;
+
+// One postfix instruction of a compiled formula
+typedef struct {
+    sim_formula_opcode_t opcode;
+    float constant;              // pushed by SIM_FORMULA_CONSTANT
+    const sim_value_t* value;    // current value of the field pushed by SIM_FORMULA_FIELD
+} sim_formula_instruction_t;
+
+// dependent_value formula compiled once to postfix, field names are already resolved so evaluating it
+// doesn't search, parse, or allocate
+typedef struct {
+    sim_formula_instruction_t* code;
+    int length;
+} sim_formula_t;
+
+// Algorithm parameters of a field, parsed from its config entry once when the component is loaded with the
+// algorithm defaults filled in. Every algorithm's parameters are kept, not just the configured one's, since
+// thrown errors and DCU commands switch fields to other algorithms at runtime.
+typedef struct {
+    struct {
+        float base_value;
+        float amplitude;
+        float frequency;
+        float phase_offset;
+    } sine_wave;
+    struct {
+        float start_value;
+        float end_value;
+        float duration_seconds;
+    } linear_decay;
+    struct {
+        float end_value;
+        float duration_seconds;          // rapid_duration_seconds in the config
+    } rapid_linear_decay;
+    struct {
+        float growth_rate;               // rapid_growth_rate in the config
+    } rapid_linear_growth;
+    struct {
+        float start_value;
+        float growth_rate;
+        float max_value;
+    } linear_growth;
+    struct {
+        float growth_rate;
+        float end_value;                 // end_value_constant_growth in the config
+    } linear_growth_constant;
+    struct {
+        float decay_rate;
+        float end_value;                 // end_value_constant_decay in the config
+    } linear_decay_constant;
+    struct {
+        char* formula;                   // NULL when missing
+    } dependent_value;
+    struct {
+        char* file_path;                 // NULL when missing
+        char* field_path;                // NULL when missing
+        char* reset_value;               // written back to the data file on reset, NULL when there is none
+    } external_value;
+
+    // Values the config gives explicitly, initialization and reset only overwrite the current value with these
+    bool has_base_value;
+    bool has_start_value;
+    float start_value;
+} sim_field_params_t;
+
 typedef struct {
     char* field_name;
     char* component_name;
@@ -49,8 +136,8 @@ typedef struct {
     sim_value_t current_value;
     sim_value_t previous_value;
 
-    // Algorithm parameters (parsed from JSON)
-    cJSON* params;
+    // Algorithm parameters (parsed from JSON at load time)
+    sim_field_params_t params;
 
     // Dependencies
     char** depends_on;
@@ -61,7 +148,16 @@ typedef struct {
     bool active; //whether the field should be actively updating (used for fields that depend on DCU commands)
     float start_time;
     bool rapid_algo_initialized;
+    float rapid_start_value; // value the rapid algorithms started from, captured once they are initialized
     bool initialized;
+    sim_formula_t formula; // compiled from params.dependent_value.formula by sim_engine_initialize
+
+    int external_handle; // handle from engine->bind_external_value for external_value fields, -1 when unbound
+
+    // Precomputed at load time so updates don't compare names
+    int component_index;         // index of the owning component in engine->components
+    sim_dcu_gate_t dcu_gate;
+    unsigned int error_mask;     // bit n set when error type n keeps the field active regardless of its DCU gate
 } sim_field_t;
 
 typedef struct {
@@ -96,6 +192,11 @@ typedef struct {
 
     sim_DCU_field_settings_t* dcu_field_settings;
 
+    // Optional source for external_value fields, when NULL the values are read from the data folder.
+    // Each field's file_path/field_path is bound to a handle once, every update then reads through the handle.
+    int (*bind_external_value)(const char* file_path, const char* field_path);
+    bool (*read_external_value)(int handle, float* value);
+
     bool initialized;
 } sim_engine_t;
 
@@ -1,11 +1,24 @@
 // network.c - handles all socket operations, HTTP server functionality
 
+// recvmmsg and sendmmsg are GNU extensions
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE
+#endif
+
 #include "network.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <signal.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include "lib/gzip/gzip.h"
+
+// Frontend files shared by every worker thread
+static struct asset_cache_t asset_cache = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+static void release_asset(struct static_asset_t *asset);
 
 /**
  * Initializes high-precision timing for the given platform.
@@ -192,6 +205,12 @@ SOCKET create_udp_socket(char *hostname, char *port) {
         return -1;
     }
 
+    // Let every worker thread bind its own UDP socket to the same port
+#if defined(SO_REUSEPORT)
+    int reuse = 1;
+    setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, (const char *)&reuse, sizeof(int));
+#endif
+
     printf("Binding UDP Socket...\n");
     int bind_result = bind(server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr));
     if (bind_result == -1) {
@@ -236,8 +255,13 @@ SOCKET create_tcp_socket(char *hostname, char *port) {
     }
 
     // Enable socket reuse to avoid "Address already in use" errors
-    char c = 1;
-    setsockopt(socket_listen, SOL_SOCKET, SO_REUSEADDR, &c, sizeof(int));
+    int c = 1;
+    setsockopt(socket_listen, SOL_SOCKET, SO_REUSEADDR, (const char *)&c, sizeof(int));
+
+    // Let every worker thread bind its own listening socket to the same port
+#if defined(SO_REUSEPORT)
+    setsockopt(socket_listen, SOL_SOCKET, SO_REUSEPORT, (const char *)&c, sizeof(int));
+#endif
 
     printf("Binding HTTP Socket...\n");
     if (bind(socket_listen, bind_address->ai_addr, bind_address->ai_addrlen)) {
@@ -257,167 +281,593 @@ SOCKET create_tcp_socket(char *hostname, char *port) {
 }
 
 /**
- * Finds an existing client by socket or creates a new client entry.
- * Maintains a linked list of active client connections.
- * 
- * @param clients Pointer to head of client list
- * @param socket Socket descriptor to search for
- * @return Client structure, newly allocated if not found
+ * Allocates every client of a connection pool up front.
+ *
+ * @param pool Pool to set up
+ * @param capacity Largest number of connections open at once
+ * @return true on success
  */
-struct client_info_t *get_client(struct client_info_t **clients, SOCKET socket) {
-    // look for the client in the linked list
-    struct client_info_t *client = *clients;
-    while (client) {
-        if (client->socket == socket) {
-            return client;
-        }
-        client = client->next;
+bool client_pool_create(struct client_pool_t *pool, int capacity) {
+    memset(pool, 0, sizeof(struct client_pool_t));
+
+    pool->slots = calloc(capacity, sizeof(struct client_info_t));
+    pool->free_slots = malloc(capacity * sizeof(int));
+    if (!pool->slots || !pool->free_slots) {
+        fprintf(stderr, "Failed to allocate memory for %d client connections\n", capacity);
+        client_pool_destroy(pool);
+        return false;
+    }
+
+    // Hand out the lowest slots first
+    pool->capacity = capacity;
+    for (int i = 0; i < capacity; i++) {
+        pool->free_slots[i] = capacity - 1 - i;
     }
+    pool->free_count = capacity;
 
-    // client not found, make one
-    struct client_info_t *new_client = (struct client_info_t *)malloc(sizeof(struct client_info_t));
-    if (new_client == NULL) {
-        fprintf(stderr, "Failed to allocate memory for new client\n");
+    return true;
+}
+
+/**
+ * Frees the clients of a pool, connections still open should be dropped first.
+ */
+void client_pool_destroy(struct client_pool_t *pool) {
+    free(pool->slots);
+    free(pool->free_slots);
+    memset(pool, 0, sizeof(struct client_pool_t));
+}
+
+/**
+ * Takes an unused client from the pool and adds it to the pool's open connections.
+ * 
+ * @param pool Connection pool of the worker
+ * @return Zeroed client structure, NULL if every connection is in use
+ */
+struct client_info_t *get_client(struct client_pool_t *pool) {
+    if (pool->free_count == 0) {
         return NULL;
     }
 
+    int slot = pool->free_slots[--pool->free_count];
+    struct client_info_t *client = &pool->slots[slot];
+
     // Zero-initialize struct, especially the request buffer for null termination
-    memset(new_client, 0, sizeof(struct client_info_t));
+    memset(client, 0, sizeof(struct client_info_t));
 
-    new_client->address_length = sizeof(new_client->address);
-    new_client->received = 0;
-    new_client->message_size = -1;
+    client->slot = slot;
+    client->address_length = sizeof(client->address);
+    client->received = 0;
+    client->keep_alive = true;   // HTTP/1.1 default until a request says otherwise
+    http_parser_init(&client->parser);
 
-    new_client->next = *clients;
-    *clients = new_client;
+    client->next = pool->open;
+    if (pool->open) {
+        pool->open->prev = client;
+    }
+    pool->open = client;
 
-    return new_client;
+    return client;
 }
 
 /**
- * Removes a UDP client from the client list without closing the socket.
- * UDP clients don't maintain persistent connections like TCP clients.
+ * Removes a client from the pool's open connections and returns it to the free slots without closing the
+ * socket. Used when the connection is handed to another thread, such as a telemetry stream.
  */
-void drop_udp_client(struct client_info_t **clients, struct client_info_t *client) {
-    struct client_info_t **p = clients;
+void detach_client(struct client_pool_t *pool, struct client_info_t *client) {
+    http_parser_reset(&client->parser);
 
-    while (*p) {
-        if (*p == client) {
-            *p = client->next;
-            free(client);
-            return;
-        }
-        p = &((*p)->next);
+    free(client->output);
+    client->output = NULL;
+    client->output_length = 0;
+    client->output_offset = 0;
+    client->output_capacity = 0;
+
+    if (client->prev) {
+        client->prev->next = client->next;
+    } else {
+        pool->open = client->next;
+    }
+    if (client->next) {
+        client->next->prev = client->prev;
     }
 
-    fprintf(stderr, "drop_client: client not found\n");
-    exit(1);
+    client->prev = NULL;
+    client->next = NULL;
+    pool->free_slots[pool->free_count++] = client->slot;
 }
 
 /**
- * Removes a TCP client, closes the socket, and frees memory.
- * Maintains the integrity of the client linked list.
+ * Closes a TCP client's socket and returns the client to the pool.
  */
-void drop_tcp_client(struct client_info_t **clients, struct client_info_t *client) {
+void drop_tcp_client(struct client_pool_t *pool, struct client_info_t *client) {
     CLOSESOCKET(client->socket);
 
-    struct client_info_t **p = clients;
-
-    while (*p) {
-        if (*p == client) {
-            *p = client->next;
-            free(client);
-            return;
-        }
-        p = &((*p)->next);
+    if (client->pending_asset) {
+        release_asset(client->pending_asset);
+        client->pending_asset = NULL;
     }
 
-    fprintf(stderr, "drop_client: client not found\n");
-    exit(1);
+    detach_client(pool, client);
 }
 
 /**
  * Converts client's TCP socket address to a readable IP string.
- * Uses a static buffer, so subsequent calls overwrite previous results.
+ * Writes into the caller's buffer, so worker threads can format addresses at the same time.
  * 
  * @param client Client structure with address information
- * @return IP address string or "unknown" on error
+ * @param buffer Buffer the string is written to, ADDRESS_BUFFER_SIZE bytes fit any address
+ * @param buffer_size Size of buffer in bytes
+ * @return buffer, holding the IP address string or "unknown" on error
  */
-const char *get_client_address(struct client_info_t *client) {
-    static char address_buffer[100];
-    
-    if (!client) {
-        strcpy(address_buffer, "unknown");
-        return address_buffer;
+const char *get_client_address(struct client_info_t *client, char *buffer, size_t buffer_size) {
+    if (!client || getnameinfo((struct sockaddr *)&client->address, client->address_length, buffer,
+                               (socklen_t)buffer_size, 0, 0, NI_NUMERICHOST) != 0) {
+        snprintf(buffer, buffer_size, "unknown");
     }
-    
-    if (getnameinfo((struct sockaddr *)&client->address, client->address_length, address_buffer,
-                    sizeof(address_buffer), 0, 0, NI_NUMERICHOST) != 0) {
-        strcpy(address_buffer, "unknown");
-    }
-    
-    return address_buffer;
+
+    return buffer;
 }
 
 /**
- * Converts client's UDP address to a readable IP string.
- * Separate from TCP address as UDP clients can have different addressing.
+ * Converts the sender of a UDP datagram to a readable IP string.
+ * Writes into the caller's buffer, so worker threads can format addresses at the same time.
  * 
- * @param client Client structure with UDP address information  
- * @return IP address string or "unknown" on error
+ * @param packet Datagram with its sender's address
+ * @param buffer Buffer the string is written to, ADDRESS_BUFFER_SIZE bytes fit any address
+ * @param buffer_size Size of buffer in bytes
+ * @return buffer, holding the IP address string or "unknown" on error
  */
-const char *get_client_udp_address(struct client_info_t *client) {
-    static char address_buffer[100];
-    
-    if (!client) {
-        strcpy(address_buffer, "unknown");
-        return address_buffer;
+const char *get_packet_address(const struct udp_packet_t *packet, char *buffer, size_t buffer_size) {
+    if (!packet || getnameinfo((const struct sockaddr *)&packet->address, packet->address_length, buffer,
+                               (socklen_t)buffer_size, 0, 0, NI_NUMERICHOST) != 0) {
+        snprintf(buffer, buffer_size, "unknown");
     }
-    
-    if (getnameinfo((struct sockaddr *)&client->udp_addr, client->address_length, address_buffer,
-                    sizeof(address_buffer), 0, 0, NI_NUMERICHOST) != 0) {
-        strcpy(address_buffer, "unknown");
+
+    return buffer;
+}
+
+/**
+ * Switches a socket between blocking and non-blocking mode.
+ *
+ * @param socket Socket to configure
+ * @param nonblocking true to make calls on the socket return immediately instead of waiting
+ * @return true on success
+ */
+bool set_socket_nonblocking(SOCKET socket, bool nonblocking) {
+#if defined(_WIN32)
+    u_long mode = nonblocking ? 1 : 0;
+    return ioctlsocket(socket, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
     }
-    
-    return address_buffer;
+    flags = nonblocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(socket, F_SETFL, flags) == 0;
+#endif
 }
 
 /**
- * Sets up a select() call to monitor multiple sockets for activity.
- * Monitors the server listening socket, UDP socket, and all client connections.
- * 
- * @param clients Linked list of active clients
- * @param server TCP listening socket
- * @param udp_socket UDP socket for datagram communication
- * @return File descriptor set with sockets ready for I/O
+ * Creates an event loop that monitors registered sockets for incoming data.
+ * On Linux sockets stay registered with epoll in edge-triggered mode, so waiting costs scale with the
+ * number of ready sockets rather than the number of connected clients.
+ *
+ * @param loop Event loop to initialize
+ * @return true on success
+ */
+bool event_loop_create(struct event_loop_t* loop) {
+    memset(loop, 0, sizeof(struct event_loop_t));
+
+#if defined(EVENT_LOOP_EPOLL)
+    loop->epoll_fd = epoll_create1(0);
+    if (loop->epoll_fd < 0) {
+        fprintf(stderr, "epoll_create1() failed with error: %d\n", GETSOCKETERRNO());
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+/**
+ * Releases the resources of an event loop, registered sockets are not closed.
+ */
+void event_loop_destroy(struct event_loop_t* loop) {
+#if defined(EVENT_LOOP_EPOLL)
+    close(loop->epoll_fd);
+#else
+    free(loop->registrations);
+    loop->registrations = NULL;
+    loop->registration_count = 0;
+#endif
+}
+
+/**
+ * Starts monitoring a socket for incoming data.
+ *
+ * @param loop Event loop to register with
+ * @param socket Socket to monitor
+ * @param data Pointer returned by event_loop_data when the socket is ready
+ * @return true on success
+ */
+bool event_loop_add(struct event_loop_t* loop, SOCKET socket, void* data) {
+#if defined(EVENT_LOOP_EPOLL)
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = data;
+
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, socket, &event) < 0) {
+        fprintf(stderr, "epoll_ctl() failed with error: %d\n", GETSOCKETERRNO());
+        return false;
+    }
+#else
+    if (loop->registration_count >= FD_SETSIZE) {
+        fprintf(stderr, "event_loop_add: too many sockets for select()\n");
+        return false;
+    }
+
+    if (loop->registration_count == loop->registration_capacity) {
+        int capacity = loop->registration_capacity ? loop->registration_capacity * 2 : 16;
+        struct event_registration_t* registrations =
+            realloc(loop->registrations, capacity * sizeof(struct event_registration_t));
+        if (!registrations) {
+            return false;
+        }
+        loop->registrations = registrations;
+        loop->registration_capacity = capacity;
+    }
+
+    loop->registrations[loop->registration_count].socket = socket;
+    loop->registrations[loop->registration_count].data = data;
+    loop->registrations[loop->registration_count].writable = false;
+    loop->registration_count++;
+#endif
+
+    return true;
+}
+
+/**
+ * Stops monitoring a socket, must be called before the socket is closed.
  */
-fd_set wait_on_clients(struct client_info_t *clients, SOCKET server, SOCKET udp_socket) {
-    // Non-blocking select with 100ms timeout for responsive server loop
+void event_loop_remove(struct event_loop_t* loop, SOCKET socket) {
+#if defined(EVENT_LOOP_EPOLL)
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, socket, NULL);
+#else
+    for (int i = 0; i < loop->registration_count; i++) {
+        if (loop->registrations[i].socket == socket) {
+            loop->registrations[i] = loop->registrations[--loop->registration_count];
+            return;
+        }
+    }
+#endif
+}
+
+/**
+ * Waits until at least one registered socket has incoming data or the timeout expires.
+ *
+ * @param loop Event loop to wait on
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return Number of ready sockets, use event_loop_data to fetch each one
+ */
+int event_loop_wait(struct event_loop_t* loop, int timeout_ms) {
+    loop->ready_count = 0;
+
+#if defined(EVENT_LOOP_EPOLL)
+    int ready = epoll_wait(loop->epoll_fd, loop->events, EVENT_LOOP_MAX_EVENTS, timeout_ms);
+    if (ready < 0) {
+        if (GETSOCKETERRNO() != EINTR) {
+            fprintf(stderr, "epoll_wait() failed with error: %d\n", GETSOCKETERRNO());
+        }
+        return 0;
+    }
+    loop->ready_count = ready;
+#else
     struct timeval select_wait;
-    select_wait.tv_sec = 0;
-    select_wait.tv_usec = 100000;
+    select_wait.tv_sec = timeout_ms / 1000;
+    select_wait.tv_usec = (timeout_ms % 1000) * 1000;
 
-    fd_set reads;
+    fd_set reads, writes;
     FD_ZERO(&reads);
-    FD_SET(server, &reads);
-    FD_SET(udp_socket, &reads);
-    SOCKET max_socket = server > udp_socket ? server : udp_socket;
+    FD_ZERO(&writes);
+    SOCKET max_socket = 0;
+    for (int i = 0; i < loop->registration_count; i++) {
+        FD_SET(loop->registrations[i].socket, &reads);
+        if (loop->registrations[i].writable) {
+            FD_SET(loop->registrations[i].socket, &writes);
+        }
+        if (loop->registrations[i].socket > max_socket) {
+            max_socket = loop->registrations[i].socket;
+        }
+    }
 
-    struct client_info_t *client = clients;
-    while (client) {
-        FD_SET(client->socket, &reads);
-        if (client->socket > max_socket) {
-            max_socket = client->socket;
+    if (select(max_socket + 1, &reads, &writes, 0, &select_wait) < 0) {
+        fprintf(stderr, "select() failed with error: %d\n", GETSOCKETERRNO());
+        return 0;
+    }
+
+    for (int i = 0; i < loop->registration_count && loop->ready_count < EVENT_LOOP_MAX_EVENTS; i++) {
+        if (FD_ISSET(loop->registrations[i].socket, &reads) || FD_ISSET(loop->registrations[i].socket, &writes)) {
+            loop->ready[loop->ready_count++] = loop->registrations[i].data;
         }
-        client = client->next;
     }
+#endif
 
-    if (select(max_socket + 1, &reads, 0, 0, &select_wait) < 0) {
-        fprintf(stderr, "select() failed with error: %d", GETSOCKETERRNO());
-        exit(1);
+    return loop->ready_count;
+}
+
+/**
+ * Returns the data pointer of a ready socket from the last event_loop_wait call.
+ */
+void* event_loop_data(struct event_loop_t* loop, int index) {
+#if defined(EVENT_LOOP_EPOLL)
+    return loop->events[index].data.ptr;
+#else
+    return loop->ready[index];
+#endif
+}
+
+/**
+ * Turns reporting of a registered socket becoming writable on or off, used while a response that did not
+ * fit the socket buffer is waiting to be sent.
+ *
+ * @param loop Event loop the socket is registered with
+ * @param socket Registered socket
+ * @param data Data pointer the socket was registered with
+ * @param writable true to also report the socket when it can be written to
+ * @return true on success
+ */
+bool event_loop_watch_writable(struct event_loop_t* loop, SOCKET socket, void* data, bool writable) {
+#if defined(EVENT_LOOP_EPOLL)
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (writable ? EPOLLOUT : 0);
+    event.data.ptr = data;
+
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_MOD, socket, &event) < 0) {
+        fprintf(stderr, "epoll_ctl() failed with error: %d\n", GETSOCKETERRNO());
+        return false;
+    }
+#else
+    (void)data;
+    for (int i = 0; i < loop->registration_count; i++) {
+        if (loop->registrations[i].socket == socket) {
+            loop->registrations[i].writable = writable;
+            return true;
+        }
+    }
+    return false;
+#endif
+
+    return true;
+}
+
+/**
+ * Sends several buffers with a single gather write (one datagram for UDP), so large payloads that are
+ * already in memory can be sent behind a small header without assembling a new buffer.
+ *
+ * @param socket Socket to send from
+ * @param address Destination address, NULL for connected sockets
+ * @param address_length Size of the destination address
+ * @param segments Buffers to send in order, at most MAX_SEND_SEGMENTS
+ * @param segment_count Number of buffers
+ * @param flags Flags passed to the send call, e.g. MSG_DONTWAIT
+ * @return Number of bytes sent, or -1 on error
+ */
+int send_segments(SOCKET socket, const struct sockaddr_in* address, socklen_t address_length,
+                  const struct send_segment_t* segments, int segment_count, int flags) {
+    if (segment_count < 0 || segment_count > MAX_SEND_SEGMENTS) {
+        return -1;
+    }
+
+#if defined(_WIN32)
+    WSABUF buffers[MAX_SEND_SEGMENTS];
+    for (int i = 0; i < segment_count; i++) {
+        buffers[i].buf = (char*)segments[i].data;
+        buffers[i].len = (ULONG)segments[i].length;
+    }
+
+    DWORD bytes_sent = 0;
+    if (WSASendTo(socket, buffers, segment_count, &bytes_sent, flags, (const struct sockaddr*)address,
+                  address ? address_length : 0, NULL, NULL) != 0) {
+        return -1;
+    }
+    return (int)bytes_sent;
+#else
+    struct iovec buffers[MAX_SEND_SEGMENTS];
+    for (int i = 0; i < segment_count; i++) {
+        buffers[i].iov_base = (void*)segments[i].data;
+        buffers[i].iov_len = segments[i].length;
     }
 
-    return reads;
+    struct msghdr message = {0};
+    message.msg_name = (void*)address;
+    message.msg_namelen = address ? address_length : 0;
+    message.msg_iov = buffers;
+    message.msg_iovlen = segment_count;
+    return (int)sendmsg(socket, &message, flags);
+#endif
+}
+
+/**
+ * Reads the datagrams waiting on a UDP socket, up to max_count of them with a single recvmmsg call on Linux.
+ * Other platforms read them one recvfrom at a time.
+ *
+ * @param socket Non-blocking UDP socket
+ * @param packets Array of max_count packets, each one receives a datagram, its length, and its sender
+ * @param max_count Largest number of datagrams to read, at most UDP_BATCH_SIZE
+ * @return Number of datagrams read, 0 if none were waiting
+ */
+int receive_datagrams(SOCKET socket, struct udp_packet_t* packets, int max_count) {
+    if (max_count > UDP_BATCH_SIZE) {
+        max_count = UDP_BATCH_SIZE;
+    }
+
+#if defined(__linux__)
+    struct mmsghdr messages[UDP_BATCH_SIZE];
+    struct iovec buffers[UDP_BATCH_SIZE];
+    memset(messages, 0, sizeof(struct mmsghdr) * max_count);
+
+    for (int i = 0; i < max_count; i++) {
+        buffers[i].iov_base = packets[i].data;
+        buffers[i].iov_len = MAX_UDP_REQUEST_SIZE;
+        messages[i].msg_hdr.msg_name = &packets[i].address;
+        messages[i].msg_hdr.msg_namelen = sizeof(packets[i].address);
+        messages[i].msg_hdr.msg_iov = &buffers[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int count = recvmmsg(socket, messages, max_count, MSG_DONTWAIT, NULL);
+    if (count < 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        packets[i].length = (int)messages[i].msg_len;
+        packets[i].address_length = messages[i].msg_hdr.msg_namelen;
+    }
+    return count;
+#else
+    int count = 0;
+    while (count < max_count) {
+        packets[count].address_length = sizeof(packets[count].address);
+        int received = recvfrom(socket, packets[count].data, MAX_UDP_REQUEST_SIZE, 0,
+                                (struct sockaddr*)&packets[count].address, &packets[count].address_length);
+        if (received < 0) {
+            break;
+        }
+        packets[count++].length = received;
+    }
+    return count;
+#endif
+}
+
+/**
+ * Adds a datagram to a send queue, the queue is flushed first if it is full.
+ * The caller fills in the returned message's segments.
+ *
+ * @param queue Queue to add to
+ * @param address Destination address
+ * @param address_length Size of the destination address
+ * @return Message to fill in
+ */
+struct udp_message_t* queue_datagram(struct udp_send_queue_t* queue, const struct sockaddr_in* address,
+                                     socklen_t address_length) {
+    if (queue->count == UDP_BATCH_SIZE) {
+        flush_datagrams(queue);
+    }
+
+    struct udp_message_t* message = &queue->messages[queue->count++];
+    message->address = *address;
+    message->address_length = address_length;
+    message->segment_count = 0;
+    return message;
+}
+
+/**
+ * Waits until a socket can take more data, used when a non-blocking send found the send buffer full.
+ *
+ * @param socket Socket to wait for
+ * @return true if the socket became writable within UDP_SEND_WAIT_MS
+ */
+static bool wait_until_writable(SOCKET socket) {
+#if defined(_WIN32)
+    WSAPOLLFD descriptor = {socket, POLLWRNORM, 0};
+    return WSAPoll(&descriptor, 1, UDP_SEND_WAIT_MS) > 0;
+#else
+    struct pollfd descriptor = {socket, POLLOUT, 0};
+    int ready;
+    do {
+        ready = poll(&descriptor, 1, UDP_SEND_WAIT_MS);
+    } while (ready < 0 && errno == EINTR);
+    return ready > 0;
+#endif
+}
+
+/**
+ * Decides what to do with a datagram whose send failed. When the socket was only out of buffer space the
+ * caller waits for it and sends the same datagram again, any other error is logged and the datagram dropped.
+ *
+ * @param socket Socket the send failed on
+ * @return true if the datagram should be sent again
+ */
+static bool retry_datagram(SOCKET socket) {
+    if (SOCKETSENDBUSY()) {
+        if (wait_until_writable(socket)) {
+            return true;
+        }
+        fprintf(stderr, "UDP socket stayed full for %d ms, dropping a datagram\n", UDP_SEND_WAIT_MS);
+        return false;
+    }
+
+    fprintf(stderr, "UDP send failed with error: %d, dropping a datagram\n", GETSOCKETERRNO());
+    return false;
+}
+
+/**
+ * Sends every queued datagram, with as few sendmmsg calls as possible on Linux. When the socket's send
+ * buffer is full the queue waits for it and sends the same datagram again, a datagram is only dropped after
+ * a hard error or when the socket stays full for UDP_SEND_WAIT_MS.
+ *
+ * @param queue Queue to send and empty
+ */
+void flush_datagrams(struct udp_send_queue_t* queue) {
+#if defined(__linux__)
+    struct mmsghdr messages[UDP_BATCH_SIZE];
+    struct iovec buffers[UDP_BATCH_SIZE * UDP_MESSAGE_SEGMENTS];
+    memset(messages, 0, sizeof(struct mmsghdr) * queue->count);
+
+    for (int i = 0; i < queue->count; i++) {
+        struct udp_message_t* message = &queue->messages[i];
+        struct iovec* message_buffers = &buffers[i * UDP_MESSAGE_SEGMENTS];
+        for (int j = 0; j < message->segment_count; j++) {
+            message_buffers[j].iov_base = (void*)message->segments[j].data;
+            message_buffers[j].iov_len = message->segments[j].length;
+        }
+        messages[i].msg_hdr.msg_name = &message->address;
+        messages[i].msg_hdr.msg_namelen = message->address_length;
+        messages[i].msg_hdr.msg_iov = message_buffers;
+        messages[i].msg_hdr.msg_iovlen = message->segment_count;
+    }
+
+    int sent = 0;
+    while (sent < queue->count) {
+        int result = sendmmsg(queue->socket, messages + sent, queue->count - sent, 0);
+        if (result > 0) {
+            sent += result;
+        } else if (!retry_datagram(queue->socket)) {
+            sent++;
+        }
+    }
+#else
+    for (int i = 0; i < queue->count; i++) {
+        struct udp_message_t* message = &queue->messages[i];
+        bool sent;
+        do {
+            sent = send_segments(queue->socket, &message->address, message->address_length, message->segments,
+                                 message->segment_count, 0) >= 0;
+        } while (!sent && retry_datagram(queue->socket));
+    }
+#endif
+
+    queue->count = 0;
+}
+
+/**
+ * Sends a short response held in one buffer through send_response, so it never blocks and is queued
+ * behind any output that is still waiting for the socket.
+ */
+static void send_text(struct client_info_t *client, const char *text, size_t length) {
+    const struct send_segment_t segment = {text, length};
+
+    send_response(client, &segment, 1);
+}
+
+/**
+ * Sends the interim 100 Continue response to a client that waits for it before sending the request body.
+ */
+void send_100(struct client_info_t *client) {
+    const char *c100 = "HTTP/1.1 100 Continue\r\n\r\n";
+
+    send_text(client, c100, strlen(c100));
 }
 
 /**
@@ -430,7 +880,28 @@ void send_400(struct client_info_t *client) {
         "Connection: close\r\n"
         "Content-Length: 10\r\n\r\nBadRequest";
 
-    send(client->socket, c400, strlen(c400), 0);
+    send_text(client, c400, strlen(c400));
+}
+
+/**
+ * Sends HTTP 413 Content Too Large response to client.
+ * Used for request bodies longer than HTTP_MAX_BODY_SIZE, the connection is closed since the rest of the body
+ * is not read.
+ */
+void send_413(struct client_info_t *client) {
+    const char *c413 =
+        "HTTP/1.1 413 Content Too Large\r\n"
+        "Connection: close\r\n"
+        "Content-Length: 15\r\n\r\nContentTooLarge";
+
+    send_text(client, c413, strlen(c413));
+}
+
+/**
+ * Returns the Connection header value for the client's current response.
+ */
+static const char *connection_header(struct client_info_t *client) {
+    return client->keep_alive ? "keep-alive" : "close";
 }
 
 /**
@@ -438,12 +909,27 @@ void send_400(struct client_info_t *client) {
  * Used when requested resource doesn't exist.
  */
 void send_404(struct client_info_t *client) {
-    const char *c404 =
-        "HTTP/1.1 404 Not Found\r\n"
+    char c404[128];
+    int length = snprintf(c404, sizeof(c404),
+                          "HTTP/1.1 404 Not Found\r\n"
+                          "Connection: %s\r\n"
+                          "Content-Length: 9\r\n\r\nNot Found", connection_header(client));
+
+    send_text(client, c404, (size_t)length);
+}
+
+/**
+ * Sends HTTP 503 Service Unavailable to a connection that was accepted while every client slot was in use.
+ * The response fits in an empty socket buffer, so it is sent without waiting and the caller closes the socket.
+ */
+void send_503(SOCKET socket) {
+    const char *c503 =
+        "HTTP/1.1 503 Service Unavailable\r\n"
         "Connection: close\r\n"
-        "Content-Length: 9\r\n\r\nNot Found";
+        "Retry-After: 1\r\n"
+        "Content-Length: 11\r\n\r\nServer Busy";
 
-    send(client->socket, c404, strlen(c404), 0);
+    send(socket, c503, strlen(c503), MSG_DONTWAIT);
 }
 
 /**
@@ -451,45 +937,506 @@ void send_404(struct client_info_t *client) {
  * Used after successfully creating a new resource.
  */
 void send_201(struct client_info_t *client) {
-    const char *c201 =
-        "HTTP/1.1 201 Created\r\n"
-        "Connection: close\r\n"
-        "Content-Length: 7\r\n\r\nCreated";
+    char c201[128];
+    int length = snprintf(c201, sizeof(c201),
+                          "HTTP/1.1 201 Created\r\n"
+                          "Connection: %s\r\n"
+                          "Content-Length: 7\r\n\r\nCreated", connection_header(client));
+
+    send_text(client, c201, (size_t)length);
+}
+
+/**
+ * Sends HTTP 204 No Content response to client.
+ * Used after a request was applied and there is nothing to send back.
+ */
+void send_204(struct client_info_t *client) {
+    char c204[128];
+    int length = snprintf(c204, sizeof(c204),
+                          "HTTP/1.1 204 No Content\r\n"
+                          "Connection: %s\r\n\r\n", connection_header(client));
+
+    send_text(client, c204, (size_t)length);
+}
 
-    send(client->socket, c201, strlen(c201), 0);
+/**
+ * Sends HTTP 304 Not Modified response to client, header-only.
+ * Used when the client's cached copy of the resource is still current.
+ *
+ * @param client Client that sent the conditional request
+ * @param etag Current entity tag of the resource, quoted
+ */
+void send_304(struct client_info_t *client, const char *etag) {
+    char c304[256];
+    int length = snprintf(c304, sizeof(c304),
+                          "HTTP/1.1 304 Not Modified\r\n"
+                          "Connection: %s\r\n"
+                          "ETag: %s\r\n"
+                          "Cache-Control: no-cache\r\n\r\n", connection_header(client), etag);
+
+    const struct send_segment_t segment = {c304, (size_t)length};
+    send_response(client, &segment, 1);
 }
 
 /**
- * Sends HTTP 304 Not Modified response to client.
- * Used when resource hasn't changed since last request.
+ * Copies the value of a request header, header names are matched case-insensitively.
+ *
+ * @param request Request text starting anywhere in the request line, headers end at the first empty line
+ * @param name Header name without the colon e.g. "If-None-Match"
+ * @param value Buffer for the value without leading whitespace
+ * @param value_size Size of the value buffer, longer values are truncated
+ * @return true if the header was found
  */
-void send_304(struct client_info_t *client) {
-    const char *c304 =
-        "HTTP/1.1 304 Not Modified\r\n"
-        "Connection: keep-alive\r\n"
-        "Content-Length: 12\r\n\r\nNot Modified";
+bool get_request_header(const char *request, const char *name, char *value, size_t value_size) {
+    size_t name_length = strlen(name);
+
+    for (const char *line = strstr(request, "\r\n"); line && strncmp(line, "\r\n\r\n", 4) != 0;
+         line = strstr(line + 2, "\r\n")) {
+        const char *header = line + 2;
+        if (strncasecmp(header, name, name_length) == 0 && header[name_length] == ':') {
+            const char *start = header + name_length + 1;
+            while (*start == ' ' || *start == '\t') {
+                start++;
+            }
+
+            size_t length = strcspn(start, "\r\n");
+            if (length >= value_size) {
+                length = value_size - 1;
+            }
+            memcpy(value, start, length);
+            value[length] = 0;
+            return true;
+        }
+    }
 
-    send(client->socket, c304, strlen(c304), 0);
+    return false;
 }
 
 /**
- * Resets client's request buffer for reuse on persistent connections.
- * Allows the same TCP connection to handle multiple HTTP requests.
+ * Checks if the client accepts gzip content coding, either by name or through "*", and did not refuse it
+ * with a quality of 0.
+ *
+ * @param request Request text starting anywhere in the request line
+ * @return true if a gzip body can be sent
  */
-void reset_client_request_buffer(struct client_info_t *client) {
+bool request_accepts_gzip(const char *request) {
+    char value[256];
+    if (!get_request_header(request, "Accept-Encoding", value, sizeof(value))) {
+        return false;
+    }
+
+    const char *position = value;
+    while (*position) {
+        while (*position == ' ' || *position == ',') {
+            position++;
+        }
+        size_t length = strcspn(position, ",");
+        size_t name_length = strcspn(position, " ;,");
+
+        if ((name_length == 4 && strncasecmp(position, "gzip", 4) == 0) ||
+            (name_length == 1 && position[0] == '*')) {
+            // A quality of 0 (q=0, q=0.0, ...) means the coding is not acceptable
+            const char *quality = strstr(position, "q=");
+            if (!quality || quality >= position + length) {
+                return true;
+            }
+            return strtod(quality + 2, NULL) > 0.0;
+        }
+        position += length;
+    }
+
+    return false;
+}
+
+/**
+ * Checks the conditional headers of a request against the current version of a resource. If-None-Match
+ * takes precedence, If-Modified-Since is only used when the client sent no entity tags.
+ *
+ * @param request Request text starting anywhere in the request line
+ * @param etag Current entity tag of the resource, quoted
+ * @param last_modified Current Last-Modified date of the resource, NULL if it has none
+ * @return true if the client's copy is current and a 304 should be sent
+ */
+bool request_not_modified(const char *request, const char *etag, const char *last_modified) {
+    char value[512];
+
+    if (get_request_header(request, "If-None-Match", value, sizeof(value))) {
+        if (strcmp(value, "*") == 0) {
+            return true;
+        }
+
+        // Weak comparison, a W/ prefix or a list of tags still matches
+        return strstr(value, etag) != NULL;
+    }
+
+    return last_modified && get_request_header(request, "If-Modified-Since", value, sizeof(value)) &&
+           strcmp(value, last_modified) == 0;
+}
+
+/**
+ * Removes a handled request from the client's buffer so the connection can be reused.
+ * Pipelined requests that arrived behind it are moved to the front of the buffer.
+ *
+ * @param client Client whose request was handled
+ * @param request_length Size of the handled request including its body
+ */
+void reset_client_request_buffer(struct client_info_t *client, int request_length) {
+    if (request_length > client->received) {
+        request_length = client->received;
+    }
+
     // This allows a client to send a new request over the same socket
-    client->received = 0;
-    memset(client->request, 0, MAX_REQUEST_SIZE);
+    client->received -= request_length;
+    memmove(client->request, client->request + request_length, client->received);
+    client->request[client->received] = 0;
+}
+
+/**
+ * Drops a reference to a cached asset and frees it once nobody uses it anymore.
+ */
+static void release_asset(struct static_asset_t *asset) {
+    if (atomic_fetch_sub(&asset->references, 1) == 1) {
+        free(asset->path);
+        free(asset->identity.header);
+        free(asset->identity.body);
+        free(asset->gzip.header);
+        free(asset->gzip.body);
+        free(asset);
+    }
+}
+
+/**
+ * Formats a time as an HTTP date e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+ */
+static void format_http_date(time_t time, char *buffer, size_t size) {
+    struct tm utc;
+#if defined(_WIN32)
+    gmtime_s(&utc, &time);
+#else
+    gmtime_r(&time, &utc);
+#endif
+    strftime(buffer, size, "%a, %d %b %Y %H:%M:%S GMT", &utc);
+}
+
+/**
+ * Checks if a content type is worth compressing, images and fonts in this folder are compressed already.
+ */
+static bool compressible_content_type(const char *content_type) {
+    return strncmp(content_type, "text/", 5) == 0 || strcmp(content_type, "application/javascript") == 0 ||
+           strcmp(content_type, "application/json") == 0 || strcmp(content_type, "image/svg+xml") == 0;
+}
+
+/**
+ * Builds the response header of one encoding of an asset.
+ *
+ * @return false if memory ran out
+ */
+static bool build_variant_header(struct asset_variant_t *variant, const char *content_type,
+                                 const char *last_modified, bool gzip, bool vary) {
+    // Browsers revalidate on every use, which costs one header-only 304 while the file is unchanged
+    char header[512];
+    int header_length = snprintf(header, sizeof(header),
+                                 "HTTP/1.1 200 OK\r\n"
+                                 "Content-Length: %lu\r\n"
+                                 "Content-Type: %s\r\n"
+                                 "%s%s"
+                                 "ETag: %s\r\n"
+                                 "Last-Modified: %s\r\n"
+                                 "Cache-Control: no-cache\r\n",
+                                 (unsigned long)variant->body_length, content_type,
+                                 gzip ? "Content-Encoding: gzip\r\n" : "", vary ? "Vary: Accept-Encoding\r\n" : "",
+                                 variant->etag, last_modified);
+
+    variant->header = strdup(header);
+    variant->header_length = (size_t)header_length;
+    return variant->header != NULL;
+}
+
+/**
+ * Reads a file into a new asset and builds its response headers, the strong ETag is a 64-bit FNV-1a hash
+ * of the file contents so it only changes when the contents do. Text files also get a gzip variant,
+ * compressed once here instead of on every request.
+ *
+ * @param path Request path the asset is cached under
+ * @param full_path File to read
+ * @param info Result of stat on the file
+ * @return New asset holding one reference, or NULL if the file could not be read
+ */
+static struct static_asset_t *load_asset(const char *path, const char *full_path, const struct stat *info) {
+    FILE *fp = fopen(full_path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+
+    struct static_asset_t *asset = calloc(1, sizeof(struct static_asset_t));
+    size_t body_length = (size_t)info->st_size;
+
+    if (asset) {
+        atomic_init(&asset->references, 1);
+        asset->path = strdup(path);
+        asset->identity.body = malloc(body_length ? body_length : 1);
+        asset->identity.body_length = body_length;
+    }
+
+    bool loaded = asset && asset->path && asset->identity.body &&
+                  fread(asset->identity.body, 1, body_length, fp) == body_length;
+    fclose(fp);
+
+    if (loaded) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < body_length; i++) {
+            hash ^= (unsigned char)asset->identity.body[i];
+            hash *= 1099511628211ull;
+        }
+        snprintf(asset->identity.etag, sizeof(asset->identity.etag), "\"%016llx\"", (unsigned long long)hash);
+        format_http_date(info->st_mtime, asset->last_modified, sizeof(asset->last_modified));
+        asset->modified = info->st_mtime;
+
+        // Only kept when it is actually smaller, each encoding has its own entity tag
+        const char *content_type = get_content_type(full_path);
+        if (compressible_content_type(content_type)) {
+            asset->gzip.body = (char *)gzip_compress((const unsigned char *)asset->identity.body, body_length,
+                                                     &asset->gzip.body_length);
+            if (asset->gzip.body && asset->gzip.body_length >= body_length) {
+                free(asset->gzip.body);
+                asset->gzip.body = NULL;
+            }
+            snprintf(asset->gzip.etag, sizeof(asset->gzip.etag), "\"%016llx-gzip\"", (unsigned long long)hash);
+        }
+
+        bool vary = asset->gzip.body != NULL;
+        loaded = build_variant_header(&asset->identity, content_type, asset->last_modified, false, vary) &&
+                 (!vary || build_variant_header(&asset->gzip, content_type, asset->last_modified, true, vary));
+    }
+
+    if (!loaded) {
+        fprintf(stderr, "Failed to load %s into the asset cache\n", full_path);
+        if (asset) {
+            release_asset(asset);
+        }
+        return NULL;
+    }
+
+    return asset;
+}
+
+/**
+ * Returns the cached asset for a frontend file, loading it on first use or when the file has changed
+ * since it was cached. Files larger than ASSET_CACHE_MAX_FILE_SIZE are loaded for this response only.
+ *
+ * @param path Request path e.g. "/index.html"
+ * @param full_path File the path maps to
+ * @return Asset with a reference held for the caller, release it with release_asset, or NULL if the
+ *         file does not exist
+ */
+static struct static_asset_t *acquire_asset(const char *path, const char *full_path) {
+    struct stat info;
+    if (stat(full_path, &info) != 0 || !S_ISREG(info.st_mode)) {
+        return NULL;
+    }
+
+    if ((size_t)info.st_size > ASSET_CACHE_MAX_FILE_SIZE) {
+        return load_asset(path, full_path, &info);
+    }
+
+    pthread_mutex_lock(&asset_cache.lock);
+
+    struct static_asset_t **link = &asset_cache.assets;
+    while (*link) {
+        struct static_asset_t *asset = *link;
+        if (strcmp(asset->path, path) == 0) {
+            if (asset->modified == info.st_mtime && asset->identity.body_length == (size_t)info.st_size) {
+                atomic_fetch_add(&asset->references, 1);
+                pthread_mutex_unlock(&asset_cache.lock);
+                return asset;
+            }
+
+            // The file was edited, responses still sending the old version keep it alive until they finish
+            *link = asset->next;
+            release_asset(asset);
+            break;
+        }
+        link = &asset->next;
+    }
+
+    struct static_asset_t *asset = load_asset(path, full_path, &info);
+    if (asset) {
+        atomic_fetch_add(&asset->references, 1);
+        asset->next = asset_cache.assets;
+        asset_cache.assets = asset;
+    }
+
+    pthread_mutex_unlock(&asset_cache.lock);
+    return asset;
+}
+
+/**
+ * Frees every cached asset, called once at shutdown after all clients are gone.
+ */
+void asset_cache_clear(void) {
+    pthread_mutex_lock(&asset_cache.lock);
+    while (asset_cache.assets) {
+        struct static_asset_t *asset = asset_cache.assets;
+        asset_cache.assets = asset->next;
+        release_asset(asset);
+    }
+    pthread_mutex_unlock(&asset_cache.lock);
 }
 
 /**
- * Serves static files from the frontend directory via HTTP.
- * Handles path validation, file reading, and proper HTTP headers.
+ * Appends bytes to the client's unsent output.
+ *
+ * @return false if the buffer could not grow
+ */
+static bool append_output(struct client_info_t *client, const void *data, size_t length) {
+    if (client->output_length + length > client->output_capacity) {
+        size_t capacity = client->output_capacity ? client->output_capacity : 1024;
+        while (capacity < client->output_length + length) {
+            capacity *= 2;
+        }
+
+        char *output = realloc(client->output, capacity);
+        if (!output) {
+            return false;
+        }
+        client->output = output;
+        client->output_capacity = capacity;
+    }
+
+    memcpy(client->output + client->output_length, data, length);
+    client->output_length += length;
+    return true;
+}
+
+/**
+ * Sends a response to the client without blocking. Whatever the socket doesn't take right away is copied
+ * into the client's output and sent by send_pending_output once the socket is writable, so the caller can
+ * release the memory the segments point into as soon as this returns.
+ * A connection that failed is marked to be closed after the response.
+ *
+ * @param client Client to respond to
+ * @param segments Parts of the response in order, at most MAX_SEND_SEGMENTS
+ * @param segment_count Number of parts
+ */
+void send_response(struct client_info_t *client, const struct send_segment_t *segments, int segment_count) {
+    size_t sent = 0;
+
+    // Responses go out in order, nothing can be sent ahead of output that is still waiting
+    if (!has_pending_output(client)) {
+        int bytes_sent = send_segments(client->socket, NULL, 0, segments, segment_count, MSG_DONTWAIT);
+        if (bytes_sent < 0 && !SOCKETWOULDBLOCK()) {
+            client->keep_alive = false;
+            return;
+        }
+        sent = bytes_sent > 0 ? (size_t)bytes_sent : 0;
+        client->last_request_time = get_wall_clock(&profile_context);
+    }
+
+    // Keep the part of the response the socket didn't take
+    for (int i = 0; i < segment_count; i++) {
+        if (sent >= segments[i].length) {
+            sent -= segments[i].length;
+            continue;
+        }
+        if (!append_output(client, (const char *)segments[i].data + sent, segments[i].length - sent)) {
+            char address[ADDRESS_BUFFER_SIZE];
+            fprintf(stderr, "Failed to allocate memory for a response to %s\n",
+                    get_client_address(client, address, sizeof(address)));
+            client->keep_alive = false;
+            return;
+        }
+        sent = 0;
+    }
+}
+
+/**
+ * Checks whether part of a response to the client is still waiting for the socket to become writable.
+ */
+bool has_pending_output(const struct client_info_t *client) {
+    return client->output_offset < client->output_length || client->pending_asset != NULL;
+}
+
+/**
+ * Continues sending the client's pending output without blocking, first the copied response bytes and then
+ * the pending asset, whose header and body go out in one gather write straight from the cache.
+ *
+ * @param client Client with a pending response
+ * @return false if the connection failed, true if the response was sent or the socket is full
+ */
+bool send_pending_output(struct client_info_t *client) {
+    while (client->output_offset < client->output_length) {
+        const struct send_segment_t segment = {
+            client->output + client->output_offset, client->output_length - client->output_offset
+        };
+
+        int bytes_sent = send_segments(client->socket, NULL, 0, &segment, 1, MSG_DONTWAIT);
+        if (bytes_sent < 0) {
+            return SOCKETWOULDBLOCK();
+        }
+
+        client->output_offset += (size_t)bytes_sent;
+        client->last_request_time = get_wall_clock(&profile_context);
+    }
+
+    // Everything is sent, start over at the front of the buffer
+    client->output_length = 0;
+    client->output_offset = 0;
+
+    struct static_asset_t *asset = client->pending_asset;
+
+    while (asset) {
+        const struct asset_variant_t *variant = client->pending_variant;
+        const struct send_segment_t parts[3] = {
+            {variant->header, variant->header_length},
+            {client->pending_connection, strlen(client->pending_connection)},
+            {variant->body, variant->body_length}
+        };
+
+        // Skip the part of the response that is already sent
+        struct send_segment_t segments[3];
+        int segment_count = 0;
+        size_t skip = client->pending_offset;
+        for (int i = 0; i < 3; i++) {
+            if (skip >= parts[i].length) {
+                skip -= parts[i].length;
+                continue;
+            }
+            segments[segment_count].data = (const char *)parts[i].data + skip;
+            segments[segment_count].length = parts[i].length - skip;
+            segment_count++;
+            skip = 0;
+        }
+
+        if (segment_count == 0) {
+            // Response complete
+            client->pending_asset = NULL;
+            release_asset(asset);
+            return true;
+        }
+
+        int bytes_sent = send_segments(client->socket, NULL, 0, segments, segment_count, MSG_DONTWAIT);
+        if (bytes_sent < 0) {
+            return SOCKETWOULDBLOCK();
+        }
+
+        client->pending_offset += (size_t)bytes_sent;
+        client->last_request_time = get_wall_clock(&profile_context);
+    }
+
+    return true;
+}
+
+/**
+ * Serves static files via HTTP, frontend files come from the in-memory asset cache.
+ * Sends as much of the response as the socket takes, if anything is left the client's pending_asset is set
+ * and the rest has to be sent with send_pending_output once the socket is writable.
+ * Conditional requests for an unchanged file are answered with a 304.
  * 
  * @param client Client requesting the resource
  * @param path Requested file path (relative to frontend/)
+ * @param request Request text after the path, holding the request headers
  */
-void serve_resource(struct client_info_t *client, const char *path) {
+void serve_resource(struct client_info_t *client, const char *path, const char *request) {
     if (!client || !path) {
         if (client) send_400(client);
         return;
@@ -532,46 +1479,69 @@ void serve_resource(struct client_info_t *client, const char *path) {
     }
 #endif
 
-    FILE *fp = fopen(full_path, "rb");
+    struct static_asset_t *asset;
+    if (strncmp(path, "/data/", 6) == 0) {
+        // Files in the data folder change all the time, they are read for this response only
+        struct stat info;
+        asset = stat(full_path, &info) == 0 && S_ISREG(info.st_mode) ? load_asset(path, full_path, &info) : NULL;
+    } else {
+        asset = acquire_asset(path, full_path);
+    }
 
-    if (!fp) {
+    if (!asset) {
         send_404(client);
         return;
     }
 
-    // Determine file size for Content-Length header
-    fseek(fp, 0L, SEEK_END);
-    size_t content_length = ftell(fp);
-    rewind(fp);
-
-    const char *content_type = get_content_type(full_path);
-
-#define BSIZE 1024  // Buffer size for file reading and HTTP headers
-
-    char content_buffer[BSIZE];
+    const struct asset_variant_t *variant =
+        asset->gzip.body && request_accepts_gzip(request) ? &asset->gzip : &asset->identity;
 
-    sprintf(content_buffer, "HTTP/1.1 200 OK\r\n");
-    send(client->socket, content_buffer, strlen(content_buffer), 0);
-
-    sprintf(content_buffer, "Connection: close\r\n");
-    send(client->socket, content_buffer, strlen(content_buffer), 0);
-
-    sprintf(content_buffer, "Content-Length: %lu\r\n", content_length);
-    send(client->socket, content_buffer, strlen(content_buffer), 0);
-
-    sprintf(content_buffer, "Content-Type: %s\r\n", content_type);
-    send(client->socket, content_buffer, strlen(content_buffer), 0);
+    if (request_not_modified(request, variant->etag, asset->last_modified)) {
+        send_304(client, variant->etag);
+        release_asset(asset);
+        return;
+    }
 
-    sprintf(content_buffer, "\r\n");
-    send(client->socket, content_buffer, strlen(content_buffer), 0);
+    client->pending_asset = asset;
+    client->pending_variant = variant;
+    client->pending_connection = client->keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    client->pending_offset = 0;
 
-    // Send file content in chunks
-    int bytes_read = fread(content_buffer, 1, BSIZE, fp);
-    while (bytes_read) {
-        send(client->socket, content_buffer, bytes_read, 0);
-        bytes_read = fread(content_buffer, 1, BSIZE, fp);
+    if (!send_pending_output(client)) {
+        // The caller closes the connection
+        client->pending_asset = NULL;
+        client->keep_alive = false;
+        release_asset(asset);
     }
-
-    fclose(fp);
 }
 
+/**
+ * Sends an in-memory document to the client as a complete HTTP response without blocking.
+ * Used for telemetry that is served from memory instead of the data folder, which may be sent gzip-compressed.
+ * Whatever the socket doesn't take is copied, so content only has to stay valid until this returns.
+ *
+ * @param client Client requesting the resource
+ * @param content Response body
+ * @param content_length Size of the body in bytes
+ * @param content_type MIME type of the body
+ * @param etag Quoted entity tag of the document, NULL to send none
+ * @param gzip true if content is gzip-compressed
+ */
+void serve_content(struct client_info_t *client, const char *content, size_t content_length,
+                   const char *content_type, const char *etag, bool gzip) {
+    char header[384];
+    int header_length = snprintf(header, sizeof(header),
+                                 "HTTP/1.1 200 OK\r\n"
+                                 "Connection: %s\r\n"
+                                 "Content-Length: %lu\r\n"
+                                 "Content-Type: %s\r\n"
+                                 "Vary: Accept-Encoding\r\n"
+                                 "%s%s%s%s\r\n",
+                                 connection_header(client), (unsigned long)content_length, content_type,
+                                 gzip ? "Content-Encoding: gzip\r\n" : "",
+                                 etag ? "ETag: " : "", etag ? etag : "",
+                                 etag ? "\r\nCache-Control: no-cache\r\n" : "");
+
+    const struct send_segment_t segments[2] = {{header, (size_t)header_length}, {content, content_length}};
+    send_response(client, segments, 2);
+}
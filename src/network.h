@@ -19,6 +19,9 @@
     #define ISVALIDSOCKET(s) ((s) != INVALID_SOCKET)
     #define CLOSESOCKET(s) closesocket(s)
     #define GETSOCKETERRNO() (WSAGetLastError())
+    #define SOCKETWOULDBLOCK() (WSAGetLastError() == WSAEWOULDBLOCK)
+    #define SOCKETSENDBUSY() (SOCKETWOULDBLOCK() || WSAGetLastError() == WSAENOBUFS)
+    #define MSG_DONTWAIT 0
 #else
     #include <sys/types.h>
     #include <sys/socket.h>
@@ -28,36 +31,176 @@
     #include <netdb.h>
     #include <unistd.h>
     #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/uio.h>
+    #include <poll.h>
 
     #define SOCKET int
     #define ISVALIDSOCKET(s) ((s) >= 0)
     #define CLOSESOCKET(s) close(s)
     #define GETSOCKETERRNO() (errno)
+    #define SOCKETWOULDBLOCK() (errno == EAGAIN || errno == EWOULDBLOCK)
+    #define SOCKETSENDBUSY() (SOCKETWOULDBLOCK() || errno == ENOBUFS)
 #endif
 
+// epoll is used on Linux, other platforms fall back to select()
+#if defined(__linux__)
+    #include <sys/epoll.h>
+    #define EVENT_LOOP_EPOLL
+    #define EVENT_LOOP_EDGE_TRIGGERED 1 // ready sockets have to be read until they would block
+#else
+    #define EVENT_LOOP_EDGE_TRIGGERED 0
+#endif
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+
 #include <math.h>
 #include <stdio.h>
 
+#include "http.h"
+
 ///////////////////////////////////////////////////////////////////////////////////
 //                                  Structs
 ///////////////////////////////////////////////////////////////////////////////////
 
 #define MAX_REQUEST_SIZE 2047
 #define MAX_UDP_REQUEST_SIZE 8008
+#define ADDRESS_BUFFER_SIZE 100         // fits any numeric IPv4 or IPv6 address from get_client_address
+#define HTTP_KEEP_ALIVE_TIMEOUT_SEC 5.0 // idle persistent connections are closed after this long
+#define DEFAULT_MAX_CONNECTIONS 1024    // HTTP connections open at once across all workers, overridden with --max-connections
+#define ASSET_CACHE_MAX_FILE_SIZE (16 * 1024 * 1024) // larger frontend files are not loaded into the cache
+
+// One content coding of a cached asset, ready to be sent
+struct asset_variant_t {
+    char* header;                // status line and entity headers, without the Connection header
+    size_t header_length;
+    char* body;                  // NULL if the asset has no such variant
+    size_t body_length;
+    char etag[32];               // quoted hash of the contents, e.g. "\"0123456789abcdef\""
+};
+
+// Frontend file held in memory together with its response headers, shared by every client that requests it.
+// Assets are immutable once loaded, a changed file is loaded into a new asset and the old one is freed when
+// its last reader releases it.
+struct static_asset_t {
+    atomic_int references;       // the cache's own reference plus one for every response still being sent
+    char* path;                  // request path e.g. "/index.html"
+    time_t modified;             // modification time of the file when it was loaded
+    char last_modified[32];      // modification time as an HTTP date
+    struct asset_variant_t identity;
+    struct asset_variant_t gzip; // compressed once when the file is loaded, only for text files it shrinks
+    struct static_asset_t* next;
+};
 
+struct asset_cache_t {
+    pthread_mutex_t lock;
+    struct static_asset_t* assets;
+};
+
+// Datagram read from a UDP socket together with its sender. UDP has no connection to keep state for, so
+// datagrams are read into a fixed set of these owned by each worker instead of into a client_info_t.
+struct udp_packet_t {
+    struct sockaddr_in address;
+    socklen_t address_length;
+    int length;                  // bytes received into data
+    char data[MAX_UDP_REQUEST_SIZE];
+};
+
+// HTTP connection
 struct client_info_t {
     socklen_t address_length;
     struct sockaddr_storage address;
-    struct sockaddr_in udp_addr;
     SOCKET socket;
     char request[MAX_REQUEST_SIZE+1];
-    char udp_request[MAX_UDP_REQUEST_SIZE];
     int received;
-    int message_size;
-    double last_request_time;
+    struct http_parser_t parser; // state of the request at the front of the buffer
+    bool keep_alive;             // whether the connection stays open after the current response
+    double last_request_time;    // last time data arrived or was sent, used to close idle persistent connections
+
+    // Response bytes the socket did not take right away, copied here so nothing they came from (such as a
+    // telemetry snapshot) has to stay held while the client reads. Sent before the pending asset.
+    char* output;
+    size_t output_length;
+    size_t output_offset;        // bytes of output already sent
+    size_t output_capacity;
+
+    // Cached asset whose response did not fit the socket buffer, the rest is sent once the socket is writable
+    struct static_asset_t* pending_asset;
+    const struct asset_variant_t* pending_variant;
+    const char* pending_connection;  // Connection header line of the pending response
+    size_t pending_offset;           // bytes of the response already sent
+
+    int slot;                    // index of the client in its pool
+    struct client_info_t* prev;  // neighbours in the pool's list of open connections
     struct client_info_t* next;
 };
 
+// Fixed set of HTTP connections owned by one worker. Every client is allocated up front, so a burst of
+// reconnects can't grow memory, and clients are taken and returned in O(1) through the free slot stack.
+struct client_pool_t {
+    struct client_info_t* slots; // capacity clients
+    int capacity;
+    int* free_slots;             // stack of unused slot indices
+    int free_count;
+    struct client_info_t* open;  // clients in use, doubly linked so one can be unlinked without a search
+};
+
+// One piece of a message sent with send_segments, the pieces are sent with a single gather write without
+// being copied together first
+#define MAX_SEND_SEGMENTS 8
+
+struct send_segment_t {
+    const void* data;
+    size_t length;
+};
+
+#define UDP_BATCH_SIZE 64               // datagrams read or sent with one system call
+#define UDP_MESSAGE_INLINE_SIZE 16      // bytes a queued datagram can carry in itself, e.g. headers and status flags
+#define UDP_MESSAGE_SEGMENTS 3
+#define UDP_SEND_WAIT_MS 100            // longest wait for a full UDP socket before a datagram is dropped
+
+// Datagram waiting in a udp_send_queue_t. Segments point into inline_data or into memory that has to stay
+// valid until the queue is flushed, such as an acquired telemetry snapshot.
+struct udp_message_t {
+    struct sockaddr_in address;
+    socklen_t address_length;
+    unsigned char inline_data[UDP_MESSAGE_INLINE_SIZE];
+    struct send_segment_t segments[UDP_MESSAGE_SEGMENTS];
+    int segment_count;
+};
+
+// Outgoing datagrams collected while a batch is handled, sent together with sendmmsg on Linux
+struct udp_send_queue_t {
+    SOCKET socket;
+    struct udp_message_t messages[UDP_BATCH_SIZE];
+    int count;
+};
+
+#define EVENT_LOOP_MAX_EVENTS 64
+
+// Readiness notification for a set of sockets, each registered socket carries a data pointer that is handed
+// back when the socket becomes readable (or writable, if requested)
+struct event_loop_t {
+#if defined(EVENT_LOOP_EPOLL)
+    int epoll_fd;
+    struct epoll_event events[EVENT_LOOP_MAX_EVENTS];
+#else
+    struct event_registration_t {
+        SOCKET socket;
+        void* data;
+        bool writable;           // also report the socket when it can be written to
+    }* registrations;
+    int registration_count;
+    int registration_capacity;
+    void* ready[EVENT_LOOP_MAX_EVENTS];
+#endif
+    int ready_count;
+};
+
 extern struct profile_context_t profile_context;
 ///////////////////////////////////////////////////////////////////////////////////
 //                                 Functions
@@ -67,18 +210,46 @@ void get_ip_address(char* hostname_out);
 const char* get_content_type(const char* path);
 SOCKET create_tcp_socket(char* hostname, char* port);
 SOCKET create_udp_socket(char* hostname, char* port);
-struct client_info_t* get_client(struct client_info_t** clients, SOCKET socket);
-void drop_udp_client(struct client_info_t** clients, struct client_info_t* client);
-void drop_tcp_client(struct client_info_t** clients, struct client_info_t* client);
-const char* get_client_address(struct client_info_t* client);
-const char* get_client_udp_address(struct client_info_t* client);
-fd_set wait_on_clients(struct client_info_t* clients, SOCKET server, SOCKET udp_socket);
+bool client_pool_create(struct client_pool_t* pool, int capacity);
+void client_pool_destroy(struct client_pool_t* pool);
+struct client_info_t* get_client(struct client_pool_t* pool);
+void detach_client(struct client_pool_t* pool, struct client_info_t* client);
+void drop_tcp_client(struct client_pool_t* pool, struct client_info_t* client);
+const char* get_client_address(struct client_info_t* client, char* buffer, size_t buffer_size);
+const char* get_packet_address(const struct udp_packet_t* packet, char* buffer, size_t buffer_size);
+bool set_socket_nonblocking(SOCKET socket, bool nonblocking);
+bool event_loop_create(struct event_loop_t* loop);
+void event_loop_destroy(struct event_loop_t* loop);
+bool event_loop_add(struct event_loop_t* loop, SOCKET socket, void* data);
+void event_loop_remove(struct event_loop_t* loop, SOCKET socket);
+int event_loop_wait(struct event_loop_t* loop, int timeout_ms);
+void* event_loop_data(struct event_loop_t* loop, int index);
+bool event_loop_watch_writable(struct event_loop_t* loop, SOCKET socket, void* data, bool writable);
+int send_segments(SOCKET socket, const struct sockaddr_in* address, socklen_t address_length,
+                  const struct send_segment_t* segments, int segment_count, int flags);
+int receive_datagrams(SOCKET socket, struct udp_packet_t* packets, int max_count);
+struct udp_message_t* queue_datagram(struct udp_send_queue_t* queue, const struct sockaddr_in* address,
+                                     socklen_t address_length);
+void flush_datagrams(struct udp_send_queue_t* queue);
+void send_100(struct client_info_t* client);
 void send_400(struct client_info_t* client);
+void send_413(struct client_info_t* client);
 void send_404(struct client_info_t* client);
+void send_503(SOCKET socket);
 void send_201(struct client_info_t* client);
-void send_304(struct client_info_t* client);
-void reset_client_request_buffer(struct client_info_t* client);
-void serve_resource(struct client_info_t* client, const char* path);
+void send_204(struct client_info_t* client);
+void send_304(struct client_info_t* client, const char* etag);
+bool get_request_header(const char* request, const char* name, char* value, size_t value_size);
+bool request_not_modified(const char* request, const char* etag, const char* last_modified);
+bool request_accepts_gzip(const char* request);
+void reset_client_request_buffer(struct client_info_t* client, int request_length);
+void serve_resource(struct client_info_t* client, const char* path, const char* request);
+void send_response(struct client_info_t* client, const struct send_segment_t* segments, int segment_count);
+bool has_pending_output(const struct client_info_t* client);
+bool send_pending_output(struct client_info_t* client);
+void asset_cache_clear(void);
+void serve_content(struct client_info_t* client, const char* content, size_t content_length,
+                   const char* content_type, const char* etag, bool gzip);
 
 ///////////////////////////////////////////////////////////////////////////////////
 //                        Cross-Platform High-Precision Timing
@@ -2,27 +2,88 @@
 
 struct profile_context_t profile_context;
 static bool debug_mode = false;
+static int flush_interval_ms = STORE_DEFAULT_FLUSH_INTERVAL_MS;
+static int worker_count = DEFAULT_WORKER_THREADS;
+static int max_connections = DEFAULT_MAX_CONNECTIONS;
+static unsigned long server_start_time; // part of every telemetry ETag
+
+// Cleared by the main thread when ENTER is pressed, the worker and simulation threads exit on their next iteration
+static atomic_bool server_running = true;
+
+static struct unreal_link_t unreal_link = {.lock = PTHREAD_MUTEX_INITIALIZER};
+static struct udp_subscriptions_t udp_subscriptions = {.lock = PTHREAD_MUTEX_INITIALIZER};
+static struct telemetry_streams_t telemetry_streams = {.lock = PTHREAD_MUTEX_INITIALIZER};
 
 // Static function declarations
 static bool continue_server(void);
+static void *worker_thread(void *arg);
+static void *simulation_thread(void *arg);
+static void accept_clients(struct event_loop_t *loop, SOCKET server, struct client_pool_t *clients);
+static void read_udp_packets(struct server_worker_t *worker);
+static void handle_udp_packet(struct udp_send_queue_t *queue, struct udp_packet_t *packet,
+                              const struct telemetry_snapshot_t *snapshot, struct backend_data_t *backend);
+static void queue_udp_status(struct udp_send_queue_t *queue, struct udp_packet_t *packet, bool result);
+static void read_client(struct event_loop_t *loop, struct client_pool_t *clients,
+                        struct client_info_t *client, struct backend_data_t *backend);
+static bool handle_client_requests(struct event_loop_t *loop, struct client_pool_t *clients,
+                                   struct client_info_t *client, struct backend_data_t *backend);
+static void close_idle_clients(struct event_loop_t *loop, struct client_pool_t *clients);
+static void close_client(struct event_loop_t *loop, struct client_pool_t *clients,
+                         struct client_info_t *client);
+static bool close_client_after_response(struct event_loop_t *loop, struct client_pool_t *clients,
+                                        struct client_info_t *client);
+static void serve_telemetry_or_resource(struct client_info_t *client, const char *path, const char *request,
+                                        struct backend_data_t *backend);
 static void get_contents(char *buffer, unsigned int *time, unsigned int *command,
                          unsigned char *data, int packet_size);
-static void tss_to_unreal(SOCKET socket, struct sockaddr_in address, socklen_t len,
+static void send_udp_response(struct udp_send_queue_t *queue, const struct sockaddr_in *address,
+                              socklen_t address_length, const unsigned char *prefix, size_t prefix_length,
+                              const void *payload, size_t payload_length, uint32_t version);
+static const char *find_telemetry_delta(const struct telemetry_snapshot_t *snapshot, int dataset,
+                                        uint64_t sent_version, double last_keyframe_time, double now,
+                                        size_t *length);
+static bool update_udp_subscription(struct udp_packet_t *packet, unsigned int command);
+static void push_udp_subscriptions(struct udp_send_queue_t *queue, struct backend_data_t *backend);
+static void open_telemetry_stream(struct event_loop_t *loop, struct client_pool_t *clients,
+                                  struct client_info_t *client, const char *query, struct backend_data_t *backend);
+static void push_telemetry_streams(struct backend_data_t *backend);
+static void request_stream_deltas(const struct telemetry_stream_t *stream, struct telemetry_store_t *store);
+static void close_telemetry_streams(void);
+static void tss_to_unreal(struct udp_send_queue_t *queue, struct sockaddr_in address, socklen_t len,
                           struct backend_data_t *backend);
 
 int main(int argc, char *argv[]) {
 
-    // Check for debug mode argument
+    // Check for command line arguments
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--debug") == 0) {
             debug_mode = true;
             printf("Debug mode enabled\n");
-            break;
+        } else if (strcmp(argv[i], "--flush-interval") == 0 && i + 1 < argc) {
+            // Time in milliseconds between writes of the same data file
+            flush_interval_ms = atoi(argv[++i]);
+            printf("Data flush interval set to %d ms\n", flush_interval_ms);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            // Number of I/O threads serving HTTP and UDP requests
+            worker_count = atoi(argv[++i]);
+            if (worker_count < 1) worker_count = 1;
+            if (worker_count > MAX_WORKER_THREADS) worker_count = MAX_WORKER_THREADS;
+        } else if (strcmp(argv[i], "--max-connections") == 0 && i + 1 < argc) {
+            // HTTP connections open at once, further connections are answered with 503 and closed
+            max_connections = atoi(argv[++i]);
+            if (max_connections < 1) max_connections = 1;
+            printf("Max HTTP connections set to %d\n", max_connections);
         }
     }
 
+    #if !defined(SO_REUSEPORT)
+        // Without SO_REUSEPORT only a single socket can be bound to the port
+        worker_count = 1;
+    #endif
+
     // Setup high precision timing
     clock_setup(&profile_context);
+    server_start_time = (unsigned long)time(NULL);
 
     // Ignore SIGPIPE signal on Unix-like systems to prevent crashes on broken pipes, this was caused before by constantly refreshing the webpage
     #if !defined(_WIN32)
@@ -38,9 +99,6 @@ int main(int argc, char *argv[]) {
         }
     #endif
 
-    // Set initial time for Unreal updates
-    double time_begin = get_wall_clock(&profile_context);
-
     // Fetch server hostname and port to bind to
     char hostname[16];
     char port[6] = "14141";
@@ -48,18 +106,6 @@ int main(int argc, char *argv[]) {
 
     printf("Launching Server at IP: %s:%s\n", hostname, port);
 
-    // Create TCP and UDP sockets for serving the website and handling UDP data requests
-    SOCKET server;
-    SOCKET udp_socket;
-
-    struct sockaddr_in unreal_addr;
-    socklen_t unreal_addr_len;
-    bool unreal = false;
-    double last_dust_message_time = 0.0;
-
-    server = create_tcp_socket(hostname, port);
-    udp_socket = create_udp_socket(hostname, port);
-
     // Initialize backend data system
     struct backend_data_t *backend = init_backend();
     if (!backend) {
@@ -67,158 +113,186 @@ int main(int argc, char *argv[]) {
         return -1;
     }
 
-    // Initialize client connection list
-    struct client_info_t *clients = NULL;
+    // Create TCP and UDP sockets for serving the website and handling UDP data requests, one pair per worker.
+    // The sockets share the port with SO_REUSEPORT, the kernel keeps each UDP sender on the same worker
+    // so commands from one device are applied in order.
+    static struct server_worker_t workers[MAX_WORKER_THREADS];
+    for (int i = 0; i < worker_count; i++) {
+        struct server_worker_t *worker = &workers[i];
+        worker->index = i;
+        worker->backend = backend;
+        worker->udp_packets = calloc(UDP_BATCH_SIZE, sizeof(struct udp_packet_t));
+        worker->server = create_tcp_socket(hostname, port);
+        worker->udp_socket = create_udp_socket(hostname, port);
+
+        // Listening sockets are drained until they would block every time they become ready
+        set_socket_nonblocking(worker->server, true);
+        set_socket_nonblocking(worker->udp_socket, true);
+
+        if (!worker->udp_packets) {
+            fprintf(stderr, "Failed to allocate UDP receive buffers\n");
+            return -1;
+        }
 
-    // Main server loop
-    while (true) {
-        fd_set reads;
-        reads = wait_on_clients(clients, server, udp_socket);
-
-        // Handle new TCP client connections
-        if (FD_ISSET(server, &reads)) {
-            struct client_info_t *client = get_client(&clients, -1);
-            if (!client) {
-                fprintf(stderr, "Failed to allocate memory for new client connection\n");
-                continue;
-            }
+        // Connections are split evenly between the workers, each one allocates its share up front
+        int worker_connections = (max_connections + worker_count - 1) / worker_count;
+        if (!client_pool_create(&worker->clients, worker_connections)) {
+            return -1;
+        }
 
-            // Accept the new connection
-            client->socket =
-                accept(server, (struct sockaddr *)&client->address, &client->address_length);
-            if (!ISVALIDSOCKET(client->socket)) {
-                fprintf(stderr, "accept() failed with error: %d\n", GETSOCKETERRNO());
-                drop_tcp_client(&clients, client);
-                continue;
-            }
+        if (!event_loop_create(&worker->loop) || !event_loop_add(&worker->loop, worker->server, &worker->server) ||
+            !event_loop_add(&worker->loop, worker->udp_socket, &worker->udp_socket)) {
+            fprintf(stderr, "Failed to initialize event loop\n");
+            return -1;
         }
+    }
 
-        // Handle UDP datagram packets
-        if (FD_ISSET(udp_socket, &reads)) {
-            struct client_info_t *udp_clients = NULL;
-            struct client_info_t *client = get_client(&udp_clients, -1);
-            if (!client) {
-                fprintf(stderr, "Failed to allocate memory for UDP client\n");
-                continue;
-            }
+    // Persist telemetry changes to the data folder in the background
+    store_start_flusher(backend->store, flush_interval_ms);
 
-            int received_bytes =
-                recvfrom(udp_socket, client->udp_request, MAX_UDP_REQUEST_SIZE, 0,
-                         (struct sockaddr *)&client->udp_addr, &client->address_length);
+    // Start the I/O workers and the simulation
+    for (int i = 0; i < worker_count; i++) {
+        pthread_create(&workers[i].thread, NULL, worker_thread, &workers[i]);
+    }
 
+    pthread_t simulation;
+    pthread_create(&simulation, NULL, simulation_thread, &workers[0]);
 
-            // Always interpret UDP packets as big-endian
-            if (!big_endian()) {
-                // System is little-endian, so convert big-endian UDP to little-endian
-                reverse_bytes(client->udp_request);     // timestamp (bytes 0-3)
-                reverse_bytes(client->udp_request + 4); // command (bytes 4-7)
+    printf("Serving requests on %d worker thread%s\n", worker_count, worker_count == 1 ? "" : "s");
 
-                // Only convert value bytes if this is a POST request (12 bytes)
-                if (received_bytes >= 12) {
-                    reverse_bytes(client->udp_request + 8); // value (bytes 8-11)
-                }
-            }
+    // Wait until the user requests server shutdown by pressing ENTER
+    while (continue_server()) {
+        #if defined(_WIN32)
+            Sleep(100);
+        #else
+            usleep(100000);
+        #endif
+    }
 
-            unsigned int time = 0;
-            unsigned int command = 0;
-            char data[4] = {0};
+    atomic_store(&server_running, false);
+    pthread_join(simulation, NULL);
+    for (int i = 0; i < worker_count; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    close_telemetry_streams();
 
-            get_contents(client->udp_request, &time, &command, data, received_bytes);
+    // Cleanup phase - shutdown server gracefully
+    printf("Clean up Database...\n");
+    cleanup_backend(backend);
 
-            // @TODO the code below could definitely be simplified further, although for the sake of clarity it's left as is for now
+    printf("Closing Sockets...\n");
+    int leftover_clients = 0;
+    for (int i = 0; i < worker_count; i++) {
+        struct server_worker_t *worker = &workers[i];
+        event_loop_destroy(&worker->loop);
+        CLOSESOCKET(worker->server);
+        CLOSESOCKET(worker->udp_socket);
+        free(worker->udp_packets);
+
+        while (worker->clients.open) {
+            drop_tcp_client(&worker->clients, worker->clients.open);
+            leftover_clients++;
+        }
+        client_pool_destroy(&worker->clients);
+    }
 
-            // Process UDP command based on command range
-            if (command < 1000) {  // GET & DUST requests
-                unsigned char *response_buffer;
-                int buffer_size = 0;
+    asset_cache_clear();
 
-                // Allocate buffer for JSON response (8 bytes header + JSON data)
-                char json_data[4096] = {0};  // Buffer for JSON content
-                handle_udp_get_request(command, (unsigned char *)json_data, backend);
+    printf("Cleaned up server listen sockets\n");
+    printf("Cleaned up %d client sockets\n", leftover_clients);
 
-                size_t json_len = strlen(json_data);
-                buffer_size = 8 + json_len + 1;  // header + JSON + null terminator
-                response_buffer = malloc(buffer_size);
-                if (!response_buffer) {
-                    fprintf(stderr, "Failed to allocate memory for GET response\n");
-                    drop_udp_client(&udp_clients, client);
-                    continue;
-                }
+    // Windows specific cleanup
+    #if defined(_WIN32)
+        WSACleanup();
+    #endif
 
-                // Prepare response packet with JSON data content
-                memcpy(response_buffer + 8, json_data, json_len + 1);
+    printf("\nGoodbye World\n");
+    return 0;
+}
 
-                // Send response
-                int bytes_sent =
-                    sendto(udp_socket, response_buffer, buffer_size, 0,
-                           (struct sockaddr *)&client->udp_addr, client->address_length);
+/**
+ * I/O worker loop, serves HTTP and UDP requests arriving on the worker's own sockets.
+ *
+ * @param arg The worker's server_worker_t
+ */
+static void *worker_thread(void *arg) {
+    struct server_worker_t *worker = (struct server_worker_t *)arg;
+    double last_idle_check = get_wall_clock(&profile_context);
+
+    while (atomic_load(&server_running)) {
+        // Wake up at least every 100ms to notice shutdown
+        int ready_count = event_loop_wait(&worker->loop, 100);
+
+        for (int i = 0; i < ready_count; i++) {
+            void *data = event_loop_data(&worker->loop, i);
+
+            if (data == &worker->server) {
+                // Handle new TCP client connections
+                accept_clients(&worker->loop, worker->server, &worker->clients);
+            } else if (data == &worker->udp_socket) {
+                // Handle UDP datagram packets
+                read_udp_packets(worker);
+            } else {
+                // Handle existing TCP client requests
+                read_client(&worker->loop, &worker->clients, (struct client_info_t *)data, worker->backend);
+            }
+        }
+
+        // Persistent connections are only closed by the client or once they sit idle for too long
+        double now = get_wall_clock(&profile_context);
+        if (now - last_idle_check >= 1.0) {
+            close_idle_clients(&worker->loop, &worker->clients);
+            last_idle_check = now;
+        }
+    }
 
+    return NULL;
+}
 
-                // UDP requests are one-off, so drop client after the response
-                drop_udp_client(&udp_clients, client);
-                free(response_buffer);
-            } else if (command == 1130) { // LIDAR
-                // Handle LIDAR data separately due to larger packet size (array of floats instead of single float value)
-                float lidar_data[LIDAR_NUM_POINTS];
+/**
+ * Simulation loop, advances the simulation at a fixed rate independent of request traffic and keeps
+ * the DUST simulation in sync with the TSS rover controls.
+ *
+ * @param arg Worker whose UDP socket is used to send updates to DUST
+ */
+static void *simulation_thread(void *arg) {
+    struct server_worker_t *worker = (struct server_worker_t *)arg;
+    struct backend_data_t *backend = worker->backend;
 
-                // Fetch all bytes after the timestamp and command (bytes 8 onward) and save that as the float array
-                memcpy(lidar_data, client->udp_request + 8, sizeof(lidar_data));
+    // Set initial time for Unreal updates
+    double time_begin = get_wall_clock(&profile_context);
 
-                // Convert from big-endian if on little-endian system
-                if (!big_endian()) {
-                    for (int i = 0; i < LIDAR_NUM_POINTS; i++) {
-                        reverse_bytes((unsigned char *)&lidar_data[i]);
-                    }
-                }
+    // Subscription pushes and Unreal updates are sent together at the end of their step
+    struct udp_send_queue_t queue;
+    queue.socket = worker->udp_socket;
+    queue.count = 0;
 
-                // Format as JSON array string: "[1.5,2.3,4.1,...]"
-                char json_array[512];
-                int offset = snprintf(json_array, sizeof(json_array), "[");
-                for (int i = 0; i < LIDAR_NUM_POINTS; i++) {
-                    if (i < LIDAR_NUM_POINTS - 1) {
-                        offset += snprintf(json_array + offset, sizeof(json_array) - offset, "%.2f,", lidar_data[i]);
-                    } else {
-                        offset += snprintf(json_array + offset, sizeof(json_array) - offset, "%.2f]", lidar_data[i]);
-                    }
-                }
+    while (atomic_load(&server_running)) {
+        // Update simulation state based on the elapsed time
+        increment_simulation(backend);
 
-                // Update ROVER JSON with new LiDAR data
-                update_json_file("ROVER", "pr_telemetry", "lidar", json_array);
-
-                drop_udp_client(&udp_clients, client);
-            } else if (command < 3000) {  // POST requests, primarily the TSS peripherals and DUST simulator (1000-2999)
-                bool result = handle_udp_post_request(command, (unsigned char *)data, backend);
-
-                // Send status of POST request back to client with just boolean response flag
-                unsigned char response_buffer[4];
-                unsigned int status = result ? 1 : 0;
-                memcpy(response_buffer, &status, 4);
-                sendto(udp_socket, response_buffer, sizeof(response_buffer), 0,
-                       (struct sockaddr *)&client->udp_addr, client->address_length);
-
-                drop_udp_client(&udp_clients, client);
-            } else if (command == 3000) {  // Unreal Engine registration (DUST simulation)
-                // This command number is sent every second, registering as a "heartbeat" for Unreal so we can display a connected status
-
-                // Set the Unreal Engine IP address so that can forward commands like brakes and throttle to the simulation
-                unreal_addr = client->udp_addr;
-                unreal_addr_len = client->address_length;
-                unreal = true;
-                last_dust_message_time = get_wall_clock(&profile_context);
-
-                drop_udp_client(&udp_clients, client);
-            } else {  // Unknown command
-                drop_udp_client(&udp_clients, client);
-            }
-        }
+        // Sync simulation data into the telemetry store
+        sync_simulation_to_json(backend);
+
+        // Push the new snapshot to subscribed clients and open web interface streams
+        push_udp_subscriptions(&queue, backend);
+        push_telemetry_streams(backend);
 
         // Send periodic telemetry updates to Unreal Engine to sync TSS rover control values with the simulation
+        pthread_mutex_lock(&unreal_link.lock);
+        bool unreal = unreal_link.connected;
+        struct sockaddr_in unreal_addr = unreal_link.address;
+        socklen_t unreal_addr_len = unreal_link.address_length;
+        double last_dust_message_time = unreal_link.last_message_time;
+        pthread_mutex_unlock(&unreal_link.lock);
+
         if (unreal) {
             double time_end = get_wall_clock(&profile_context);
             double time_diff = time_end - time_begin;
 
             if (time_diff > UNREAL_UPDATE_INTERVAL_SEC) {
-                tss_to_unreal(udp_socket, unreal_addr, unreal_addr_len, backend);
+                tss_to_unreal(&queue, unreal_addr, unreal_addr_len, backend);
+                flush_datagrams(&queue);
                 time_begin = time_end;
             }
 
@@ -230,140 +304,757 @@ int main(int argc, char *argv[]) {
             }
         }
 
-        // Handle existing TCP client requests
-        struct client_info_t *client = clients;
+        #if defined(_WIN32)
+            Sleep(SIMULATION_TICK_INTERVAL_MS);
+        #else
+            usleep(SIMULATION_TICK_INTERVAL_MS * 1000);
+        #endif
+    }
+
+    return NULL;
+}
+
+/**
+ * Accepts every pending TCP connection and registers it with the event loop.
+ *
+ * @param loop Event loop the client sockets are added to
+ * @param server TCP listening socket
+ * @param clients Connection pool of the worker
+ */
+static void accept_clients(struct event_loop_t *loop, SOCKET server, struct client_pool_t *clients) {
+    while (true) {
+        struct client_info_t *client = get_client(clients);
+        if (!client) {
+            // Every connection slot is in use, turn the connection away instead of growing the pool
+            struct sockaddr_storage address;
+            socklen_t address_length = sizeof(address);
+            SOCKET socket = accept(server, (struct sockaddr *)&address, &address_length);
+            if (!ISVALIDSOCKET(socket)) {
+                return;
+            }
+            send_503(socket);
+            CLOSESOCKET(socket);
+            continue;
+        }
+
+        // Accept the new connection
+        client->socket = accept(server, (struct sockaddr *)&client->address, &client->address_length);
+        if (!ISVALIDSOCKET(client->socket)) {
+            if (!SOCKETWOULDBLOCK()) {
+                fprintf(stderr, "accept() failed with error: %d\n", GETSOCKETERRNO());
+            }
+            drop_tcp_client(clients, client);
+            return;
+        }
+
+        // Nothing the worker does on a client socket waits, responses the socket doesn't take are queued
+        set_socket_nonblocking(client->socket, true);
+        client->last_request_time = get_wall_clock(&profile_context);
+
+        if (!event_loop_add(loop, client->socket, client)) {
+            drop_tcp_client(clients, client);
+        }
+    }
+}
+
+/**
+ * Reads every datagram waiting on the worker's UDP socket in batches of up to UDP_BATCH_SIZE and handles
+ * each one. The replies of a batch are queued and sent together once the whole batch is handled.
+ *
+ * @param worker Worker whose UDP socket is ready
+ */
+static void read_udp_packets(struct server_worker_t *worker) {
+    struct udp_send_queue_t queue;
+    queue.socket = worker->udp_socket;
+    queue.count = 0;
+
+    while (true) {
+        int count = receive_datagrams(worker->udp_socket, worker->udp_packets, UDP_BATCH_SIZE);
+        if (count == 0) {
+            // Nothing left to read
+            return;
+        }
+
+        // Every GET in the batch is answered from one snapshot, held until the queued replies are sent
+        const struct telemetry_snapshot_t *snapshot = store_acquire_snapshot(worker->backend->store);
+        for (int i = 0; i < count; i++) {
+            handle_udp_packet(&queue, &worker->udp_packets[i], snapshot, worker->backend);
+        }
+        flush_datagrams(&queue);
+        store_release_snapshot(snapshot);
+
+        if (count < UDP_BATCH_SIZE) {
+            return;
+        }
+    }
+}
+
+/**
+ * Queues the boolean status reply of a POST or subscription command.
+ */
+static void queue_udp_status(struct udp_send_queue_t *queue, struct udp_packet_t *packet, bool result) {
+    struct udp_message_t *message = queue_datagram(queue, &packet->address, packet->address_length);
+    unsigned int status = result ? 1 : 0;
+    memcpy(message->inline_data, &status, 4);
+    message->segments[message->segment_count++] = (struct send_segment_t){message->inline_data, 4};
+}
+
+/**
+ * Handles a single UDP datagram and queues the response to its sender.
+ *
+ * @param queue Queue the response is added to
+ * @param packet Datagram and the sender's address
+ * @param snapshot Snapshot GET commands are answered from, held until the queue is flushed
+ * @param backend Backend data structure containing all telemetry and simulation engines
+ */
+static void handle_udp_packet(struct udp_send_queue_t *queue, struct udp_packet_t *packet,
+                              const struct telemetry_snapshot_t *snapshot, struct backend_data_t *backend) {
+    // Always interpret UDP packets as big-endian
+    if (!big_endian()) {
+        // System is little-endian, so convert big-endian UDP to little-endian
+        reverse_bytes(packet->data);     // timestamp (bytes 0-3)
+        reverse_bytes(packet->data + 4); // command (bytes 4-7)
+
+        // The payload (bytes 8 onward) stays big-endian, POST handlers decode it for their data type
+    }
+
+    unsigned int time = 0;
+    unsigned int command = 0;
+    char data[4] = {0};
+
+    get_contents(packet->data, &time, &command, data, packet->length);
+
+    // @TODO the code below could definitely be simplified further, although for the sake of clarity it's left as is for now
+
+    // Process UDP command based on command range
+    if (command < 1000) {  // GET & DUST requests
+        bool binary = false;
+        int dataset = handle_udp_get_request(command, &binary, backend);
+
+        // Optional input value selects the JSON encoding, compact unless pretty-printing is requested
+        uint32_t encoding = ((uint32_t)(unsigned char)data[0] << 24) | ((uint32_t)(unsigned char)data[1] << 16) |
+                            ((uint32_t)(unsigned char)data[2] << 8) | (uint32_t)(unsigned char)data[3];
+
+        if (dataset < 0) {
+            static const char empty_json[1] = {0};
+            send_udp_response(queue, &packet->address, packet->address_length, NULL, 0, empty_json,
+                              sizeof(empty_json), 0);
+        } else {
+            // The JSON (with its null terminator) or binary record is sent straight from the snapshot
+            uint32_t version = (uint32_t)snapshot->versions[dataset];
+
+            if (binary) {
+                send_udp_response(queue, &packet->address, packet->address_length, NULL, 0,
+                                  snapshot->binary[dataset], snapshot->binary_length[dataset], version);
+            } else if (encoding == UDP_GET_ENCODING_PRETTY) {
+                send_udp_response(queue, &packet->address, packet->address_length, NULL, 0,
+                                  snapshot->json[dataset], snapshot->json_length[dataset] + 1, version);
+            } else {
+                send_udp_response(queue, &packet->address, packet->address_length, NULL, 0,
+                                  snapshot->compact_json[dataset], snapshot->compact_length[dataset] + 1, version);
+            }
+        }
+    } else if (command < 3000) {  // POST requests, primarily the TSS peripherals and DUST simulator (1000-2999)
+        int payload_length = packet->length > 8 ? packet->length - 8 : 0;
+        bool result = handle_udp_post_request(command, (unsigned char *)packet->data + 8,
+                                              payload_length, backend);
+
+        // Send status of POST request back to client with just boolean response flag
+        queue_udp_status(queue, packet, result);
+    } else if (command == 3000) {  // Unreal Engine registration (DUST simulation)
+        // This command number is sent every second, registering as a "heartbeat" for Unreal so we can display a connected status
+
+        // Set the Unreal Engine IP address so that can forward commands like brakes and throttle to the simulation
+        pthread_mutex_lock(&unreal_link.lock);
+        unreal_link.address = packet->address;
+        unreal_link.address_length = packet->address_length;
+        unreal_link.connected = true;
+        unreal_link.last_message_time = get_wall_clock(&profile_context);
+        pthread_mutex_unlock(&unreal_link.lock);
+    } else if (command == UDP_SUBSCRIBE_COMMAND || command == UDP_UNSUBSCRIBE_COMMAND) {
+        bool result = update_udp_subscription(packet, command);
+
+        // Same boolean response flag as POST requests
+        queue_udp_status(queue, packet, result);
+    } else if (command == UDP_BATCH_POST_COMMAND) {  // Several POST commands applied together
+        bool result = handle_udp_batch_post_request((unsigned char *)packet->data + 8,
+                                                    packet->length > 8 ? packet->length - 8 : 0, backend);
+
+        // Same boolean response flag as single POST requests
+        queue_udp_status(queue, packet, result);
+    }
+}
+
+/**
+ * Reads from a TCP client and responds once a complete HTTP request has arrived.
+ * With an edge-triggered event loop the socket is read until it would block.
+ *
+ * @param loop Event loop the client is registered with
+ * @param clients Connection pool of the worker
+ * @param client Client with incoming data
+ * @param backend Backend data structure containing all telemetry and simulation engines
+ */
+static void read_client(struct event_loop_t *loop, struct client_pool_t *clients,
+                        struct client_info_t *client, struct backend_data_t *backend) {
+    // Finish the response that is waiting for the socket to become writable before reading anything else
+    if (has_pending_output(client)) {
+        if (!send_pending_output(client)) {
+            close_client(loop, clients, client);
+            return;
+        }
+        if (has_pending_output(client)) {
+            return;
+        }
+
+        event_loop_watch_writable(loop, client->socket, client, false);
+        if (!client->keep_alive) {
+            close_client(loop, clients, client);
+            return;
+        }
+
+        // Answer requests that were pipelined behind it
+        if (!handle_client_requests(loop, clients, client, backend) || has_pending_output(client)) {
+            return;
+        }
+    }
+
+    while (true) {
+        // Check for buffer overflow on request, send 400 and drop client if so
+        if (MAX_REQUEST_SIZE <= client->received) {
+            client->keep_alive = false;
+            send_400(client);
+            close_client_after_response(loop, clients, client);
+            return;
+        }
+
+        // Read incoming data from client
+        int bytes_received = recv(client->socket, client->request + client->received,
+                                  MAX_REQUEST_SIZE - client->received, MSG_DONTWAIT);
+
+        if (bytes_received < 0 && SOCKETWOULDBLOCK()) {
+            // Wait for the rest of the request
+            return;
+        }
+
+        if (bytes_received < 1) {
+            // Closing an idle persistent connection between requests is normal, only a partial request is unexpected
+            if (client->received > 0) {
+                char address[ADDRESS_BUFFER_SIZE];
+                fprintf(stderr, "Unexpected Disconnect from %s\n", get_client_address(client, address, sizeof(address)));
+            }
+            close_client(loop, clients, client);
+            return;
+        }
+
+        client->received += bytes_received;
+        client->request[client->received] = 0;
+        client->last_request_time = get_wall_clock(&profile_context);
 
-        while (client) {
-            struct client_info_t *next_client = client->next;
+        if (!handle_client_requests(loop, clients, client, backend) || has_pending_output(client)) {
+            return;
+        }
 
-            // Process data from this client
-            if (FD_ISSET(client->socket, &reads)) {
+        // A level-triggered loop reports the socket again if more data is waiting
+        if (!EVENT_LOOP_EDGE_TRIGGERED) {
+            return;
+        }
+    }
+}
 
-                // Check for buffer overflow on request, send 400 and drop client if so
-                if (MAX_REQUEST_SIZE <= client->received) {
-                    send_400(client);
-                    drop_tcp_client(&clients, client);
-                    client = next_client;
-                    continue;
+/**
+ * Responds to every complete request in the client's buffer in the order they arrived, so pipelined
+ * requests are answered without waiting for another read.
+ *
+ * @param loop Event loop the client is registered with
+ * @param clients Connection pool of the worker
+ * @param client Client with buffered requests
+ * @param backend Backend data structure containing all telemetry and simulation engines
+ * @return false if the client was closed or handed off and must not be used anymore
+ */
+static bool handle_client_requests(struct event_loop_t *loop, struct client_pool_t *clients,
+                                   struct client_info_t *client, struct backend_data_t *backend) {
+    struct http_parser_t *parser = &client->parser;
+
+    while (true) {
+        // Only the bytes that arrived since the last call are parsed
+        http_parse_result_t result = http_parse(parser, client->request, &client->received);
+        client->request[client->received] = 0;
+
+        if (result == HTTP_PARSE_INCOMPLETE) {
+            if (http_headers_complete(parser) && parser->expect_continue) {
+                // The client holds the body back until it is told to go ahead
+                parser->expect_continue = false;
+                send_100(client);
+                if (has_pending_output(client)) {
+                    event_loop_watch_writable(loop, client->socket, client, true);
                 }
+            }
+            return true;
+        }
+
+        if (result != HTTP_PARSE_COMPLETE) {
+            // The rest of the request can't be delimited, so the connection can't be reused
+            client->keep_alive = false;
+            if (result == HTTP_PARSE_BODY_TOO_LARGE) {
+                send_413(client);
+            } else {
+                send_400(client);
+            }
+            return close_client_after_response(loop, clients, client);
+        }
+
+        client->keep_alive = parser->keep_alive;
+
+        // Pipelined requests follow the headers, end the headers of this one while it is handled
+        char next = client->request[parser->header_length];
+        client->request[parser->header_length] = 0;
+
+        char *path = client->request + parser->target_start;
+        char *end_path = path + parser->target_length;
+
+        if (parser->method == HTTP_METHOD_GET && path[0] == '/') { // HTTP GET request
+            if (strncmp(path, TELEMETRY_STREAM_PATH, strlen(TELEMETRY_STREAM_PATH)) == 0 &&
+                (path[strlen(TELEMETRY_STREAM_PATH)] == ' ' || path[strlen(TELEMETRY_STREAM_PATH)] == '?')) {
+                // The stream keeps the connection open, it is no longer served by this worker
+                *end_path = 0;
+                open_telemetry_stream(loop, clients, client, path + strlen(TELEMETRY_STREAM_PATH), backend);
+                return false;
+            }
 
-                // Read incoming data from client
-                int bytes_received = recv(client->socket, client->request + client->received,
-                                          MAX_REQUEST_SIZE - client->received, 0);
-
-                if (bytes_received < 1) {
-                    // Connection closed or error
-                    fprintf(stderr, "Unexpected Disconnect from %s\n", get_client_address(client));
-                    drop_tcp_client(&clients, client);
-                } else {
-                    client->received += bytes_received;
-                    client->request[client->received] = 0;
-
-                    // Check if we have a complete HTTP request
-                    char *q = strstr(client->request, "\r\n\r\n");
-                    if (q) { 
-                        if (strncmp(client->request, "GET /", 5) == 0) { // HTTP GET request
-                            char *path = client->request + 4;
-                            char *end_path = strstr(path, " ");
-
-                            if (!end_path) {
-                                // Malformed request
-                                send_400(client);
-                                drop_tcp_client(&clients, client);
-                            } else {
-                                // Null-terminate the path and serve the resource
-                                *end_path = 0;
-                                serve_resource(client, path);
-                                drop_tcp_client(&clients, client);
-                            }
-                        } else if (strncmp(client->request, "POST /", 6) == 0) { // HTTP POST request
-                            // Parse Content-Length header
-                            if (client->message_size == -1) {
-                                char *request_content_size_ptr =
-                                    strstr(client->request, "Content-Length: ");
-                                if (request_content_size_ptr) {
-                                    request_content_size_ptr += strlen("Content-Length: ");
-                                    client->message_size =
-                                        atoi(request_content_size_ptr) + (q - client->request) + 4;
-                                } else {
-                                    // Missing Content-Length header
-                                    send_400(client);
-                                    drop_tcp_client(&clients, client);
-                                }
-                            }
-
-                            if (client->received == client->message_size) {
-                                // Complete POST request received
-                                char *request_content = strstr(client->request, "\r\n\r\n");
-                                request_content += 4;  // Skip past header delimiter
-
-                                if (!request_content) {
-                                    send_400(client);
-                                    drop_tcp_client(&clients, client);
-                                } else {
-                                    if (html_form_json_update(request_content, backend)) {
-                                        send_304(client);
-                                    } else {
-                                        send_400(client);
-                                    }
-                                    drop_tcp_client(&clients, client);
-                                }
-                            }
-
-                        } else { //= Unsupported HTTP methods
-                            send_400(client);
-                            drop_tcp_client(&clients, client);
-                        }
-                    }
+            // Null-terminate the path and serve the resource
+            *end_path = 0;
+            serve_telemetry_or_resource(client, path, end_path + 1, backend);
+        } else if (parser->method == HTTP_METHOD_POST && path[0] == '/') { // HTTP POST request
+            // JSON bodies hold several updates, form bodies a single "route=value"
+            char empty_body[1] = {0};
+            char *request_content = parser->body ? parser->body : empty_body;
+            bool updated = parser->json_body ? html_json_batch_update(request_content, backend)
+                                             : html_form_json_update(request_content, backend);
+
+            if (updated) {
+                send_204(client);
+            } else {
+                client->keep_alive = false;
+                send_400(client);
+            }
+        } else { //= Unsupported HTTP methods
+            client->keep_alive = false;
+            send_400(client);
+        }
+
+        client->request[parser->header_length] = next;
+        reset_client_request_buffer(client, parser->header_length);
+        http_parser_reset(parser);
+
+        if (has_pending_output(client)) {
+            // The rest of the response and any pipelined requests wait until the socket is writable
+            event_loop_watch_writable(loop, client->socket, client, true);
+            return true;
+        }
+
+        if (!client->keep_alive) {
+            close_client(loop, clients, client);
+            return false;
+        }
+    }
+}
+
+/**
+ * Serves /data/EVA.json, /data/ROVER.json, and /data/LTV.json from the latest telemetry snapshot so
+ * readers never wait on the simulation or the disk, everything else is served from the frontend folder.
+ * Telemetry ETags are the dataset version, so a poll between two changes is answered with a 304.
+ *
+ * @param client Client requesting the resource
+ * @param path Requested path
+ * @param request Request text after the path, holding the request headers
+ * @param backend Backend data structure containing the telemetry store
+ */
+static void serve_telemetry_or_resource(struct client_info_t *client, const char *path, const char *request,
+                                        struct backend_data_t *backend) {
+    if (strncmp(path, "/data/", 6) == 0) {
+        const char *name = path + 6;
+        int dataset = store_dataset_from_name(name);
+
+        // Match the file names exactly, like the data folder would
+        if (dataset >= 0 && strncmp(name, backend->store->datasets[dataset].name, strcspn(name, ".")) == 0 &&
+            strcmp(name + strcspn(name, "."), ".json") == 0) {
+            const struct telemetry_snapshot_t *snapshot = store_acquire_snapshot(backend->store);
+
+            // Large documents are sent compressed when the client accepts it, each encoding has its own tag
+            bool gzip = snapshot->gzip_json[dataset] != NULL && request_accepts_gzip(request);
+
+            // Versions start over when the server restarts, the start time keeps tags from older runs from matching
+            char etag[64];
+            snprintf(etag, sizeof(etag), "\"%lx-%llu%s\"", server_start_time,
+                     (unsigned long long)snapshot->versions[dataset], gzip ? "-gzip" : "");
+
+            if (request_not_modified(request, etag, NULL)) {
+                send_304(client, etag);
+            } else if (gzip) {
+                serve_content(client, (const char *)snapshot->gzip_json[dataset], snapshot->gzip_length[dataset],
+                              "application/json", etag, true);
+            } else {
+                serve_content(client, snapshot->json[dataset], snapshot->json_length[dataset], "application/json",
+                              etag, false);
+            }
+
+            // Responses never block and keep their own copy of anything left unsent, so a client that stops
+            // reading can't hold the snapshot and stall publishing
+            store_release_snapshot(snapshot);
+            return;
+        }
+    }
+
+    serve_resource(client, path, request);
+}
+
+/**
+ * Asks the next snapshot for deltas from the versions a stream has, so its next events can be deltas.
+ */
+static void request_stream_deltas(const struct telemetry_stream_t *stream, struct telemetry_store_t *store) {
+    if (!stream->deltas) return;
+
+    for (int dataset = 0; dataset < STORE_DATASET_COUNT; dataset++) {
+        if (stream->datasets & (1u << dataset)) {
+            store_request_delta(store, dataset, stream->sent_versions[dataset]);
+        }
+    }
+}
+
+/**
+ * Sends data on a telemetry stream without blocking. Whatever the socket doesn't take is copied into the
+ * stream's output and sent by send_stream_output before anything else, so the browser never sees part of
+ * an event followed by the start of the next one.
+ *
+ * @param stream Stream to send on
+ * @param segments Data to send in order, at most MAX_SEND_SEGMENTS
+ * @param segment_count Number of segments
+ * @return false if the connection failed or more than TELEMETRY_STREAM_MAX_BACKLOG bytes would be left unsent
+ */
+static bool send_stream_data(struct telemetry_stream_t *stream, const struct send_segment_t *segments,
+                             int segment_count) {
+    size_t length = 0;
+    for (int i = 0; i < segment_count; i++) {
+        length += segments[i].length;
+    }
+
+    // Data goes out in order, nothing can be sent ahead of output that is still waiting
+    size_t sent = 0;
+    if (stream->output_offset == stream->output_length) {
+        int bytes_sent = send_segments(stream->socket, NULL, 0, segments, segment_count, MSG_DONTWAIT);
+        if (bytes_sent < 0 && !SOCKETWOULDBLOCK()) {
+            return false;
+        }
+        sent = bytes_sent > 0 ? (size_t)bytes_sent : 0;
+    }
+    if (sent == length) {
+        return true;
+    }
+
+    size_t backlog = stream->output_length - stream->output_offset + length - sent;
+    if (backlog > TELEMETRY_STREAM_MAX_BACKLOG) {
+        return false;
+    }
+
+    // Move what is still waiting to the front, so the buffer never holds more than the backlog
+    if (stream->output_offset > 0) {
+        memmove(stream->output, stream->output + stream->output_offset,
+                stream->output_length - stream->output_offset);
+        stream->output_length -= stream->output_offset;
+        stream->output_offset = 0;
+    }
+
+    if (backlog > stream->output_capacity) {
+        size_t capacity = stream->output_capacity ? stream->output_capacity : 4096;
+        while (capacity < backlog) {
+            capacity *= 2;
+        }
+        char *output = realloc(stream->output, capacity);
+        if (!output) {
+            return false;
+        }
+        stream->output = output;
+        stream->output_capacity = capacity;
+    }
+
+    // Keep the part the socket didn't take
+    for (int i = 0; i < segment_count; i++) {
+        if (sent >= segments[i].length) {
+            sent -= segments[i].length;
+            continue;
+        }
+        memcpy(stream->output + stream->output_length, (const char *)segments[i].data + sent,
+               segments[i].length - sent);
+        stream->output_length += segments[i].length - sent;
+        sent = 0;
+    }
+    return true;
+}
+
+/**
+ * Continues sending the output a telemetry stream's socket didn't take earlier, without blocking.
+ *
+ * @return false if the connection failed, true if the output was sent or the socket is full
+ */
+static bool send_stream_output(struct telemetry_stream_t *stream) {
+    while (stream->output_offset < stream->output_length) {
+        const struct send_segment_t segment = {
+            stream->output + stream->output_offset, stream->output_length - stream->output_offset
+        };
+
+        int bytes_sent = send_segments(stream->socket, NULL, 0, &segment, 1, MSG_DONTWAIT);
+        if (bytes_sent < 0) {
+            return SOCKETWOULDBLOCK();
+        }
+        stream->output_offset += (size_t)bytes_sent;
+    }
+
+    stream->output_length = 0;
+    stream->output_offset = 0;
+    return true;
+}
+
+/**
+ * Closes a telemetry stream's connection and frees the output it still held.
+ */
+static void close_telemetry_stream(struct telemetry_stream_t *stream) {
+    CLOSESOCKET(stream->socket);
+    free(stream->output);
+    stream->output = NULL;
+}
+
+/**
+ * Sends one Server-Sent Event with a dataset's compact JSON, taken from the snapshot without copying.
+ * The stream socket never blocks, the part of the event it doesn't take is kept and sent on a later tick.
+ *
+ * @return false if the stream failed or fell too far behind and has to be dropped
+ */
+static bool send_stream_event(struct telemetry_stream_t *stream, const struct telemetry_snapshot_t *snapshot,
+                              int dataset, const char *dataset_name, double now) {
+    size_t data_length = 0;
+    const char *data = stream->deltas ? find_telemetry_delta(snapshot, dataset, stream->sent_versions[dataset],
+                                                             stream->last_keyframe_time[dataset], now, &data_length)
+                                      : NULL;
+    bool delta = data != NULL;
+    if (!delta) {
+        data = snapshot->compact_json[dataset];
+        data_length = snapshot->compact_length[dataset];
+    }
+
+    // Delta events are named "<dataset>-delta" and hold a JSON merge patch for the previous event
+    char prefix[64];
+    int prefix_length = snprintf(prefix, sizeof(prefix), "event: %s%s\nid: %lu\ndata: ", dataset_name,
+                                 delta ? "-delta" : "", (unsigned long)snapshot->versions[dataset]);
+
+    struct send_segment_t segments[3] = {
+        {prefix, (size_t)prefix_length},
+        {data, data_length},
+        {"\n\n", 2}
+    };
+
+    if (!send_stream_data(stream, segments, 3)) {
+        return false;
+    }
+
+    stream->sent_versions[dataset] = snapshot->versions[dataset];
+    if (!delta) {
+        stream->last_keyframe_time[dataset] = now;
+    }
+    return true;
+}
+
+/**
+ * Turns a GET /stream request into a Server-Sent Events stream. The current state of every requested
+ * dataset is sent right away, after that the simulation thread sends each dataset whenever it changes.
+ * The datasets can be picked with a query such as /stream?datasets=EVA,ROVER, all of them are sent by default.
+ * With deltas=1 in the query, changes are sent as "<dataset>-delta" events holding only the changed fields.
+ *
+ * @param loop Event loop the client is registered with
+ * @param clients Connection pool of the worker
+ * @param client Client requesting the stream
+ * @param query Query string of the request, empty if there is none
+ * @param backend Backend data structure containing the telemetry store
+ */
+static void open_telemetry_stream(struct event_loop_t *loop, struct client_pool_t *clients,
+                                  struct client_info_t *client, const char *query, struct backend_data_t *backend) {
+    struct telemetry_stream_t stream = {0};
+    stream.socket = client->socket;
+
+    const char *datasets = strstr(query, "datasets=");
+    if (datasets) {
+        datasets += strlen("datasets=");
+        while (*datasets) {
+            char name[16] = {0};
+            size_t name_length = strcspn(datasets, ",&");
+            if (name_length < sizeof(name)) {
+                memcpy(name, datasets, name_length);
+                int dataset = store_dataset_from_name(name);
+                if (dataset >= 0) {
+                    stream.datasets |= 1u << dataset;
                 }
             }
+            datasets += name_length;
+            if (*datasets != ',') break;
+            datasets++;
+        }
+    } else {
+        stream.datasets = (1u << STORE_DATASET_COUNT) - 1;
+    }
+    stream.deltas = strstr(query, "deltas=1") != NULL;
+
+    // The worker no longer reads from this connection, unlink it without closing the socket
+    event_loop_remove(loop, client->socket);
+    detach_client(clients, client);
+
+    const char *header =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: keep-alive\r\n\r\n"
+        "retry: 1000\n\n";
+
+    pthread_mutex_lock(&telemetry_streams.lock);
+
+    if (telemetry_streams.count >= MAX_TELEMETRY_STREAMS || stream.datasets == 0) {
+        pthread_mutex_unlock(&telemetry_streams.lock);
+        const char *c503 =
+            "HTTP/1.1 503 Service Unavailable\r\n"
+            "Connection: close\r\n"
+            "Content-Length: 0\r\n\r\n";
+        send(stream.socket, c503, strlen(c503), MSG_DONTWAIT);
+        CLOSESOCKET(stream.socket);
+        return;
+    }
+
+    set_socket_nonblocking(stream.socket, true);
+    const struct send_segment_t header_segment = {header, strlen(header)};
+    bool sent = send_stream_data(&stream, &header_segment, 1);
 
-            // Move to the next client in the list
-            client = next_client;
+    double now = get_wall_clock(&profile_context);
+    const struct telemetry_snapshot_t *snapshot = store_acquire_snapshot(backend->store);
+    for (int i = 0; i < STORE_DATASET_COUNT && sent; i++) {
+        if (stream.datasets & (1u << i)) {
+            sent = send_stream_event(&stream, snapshot, i, backend->store->datasets[i].name, now);
         }
+    }
+    store_release_snapshot(snapshot);
 
-        // Check if user requested server shutdown by pressing ENTER
-        if (!continue_server()) {
-            break;
+    if (sent) {
+        stream.last_send_time = now;
+        request_stream_deltas(&stream, backend->store);
+        telemetry_streams.entries[telemetry_streams.count++] = stream;
+    } else {
+        close_telemetry_stream(&stream);
+    }
+
+    pthread_mutex_unlock(&telemetry_streams.lock);
+}
+
+/**
+ * Sends every changed dataset to the open telemetry streams, all streams are served from the same snapshot.
+ * Whatever a stream's socket didn't take on an earlier tick is sent first. Streams that were closed by the
+ * browser or fall more than TELEMETRY_STREAM_MAX_BACKLOG bytes behind are dropped, EventSource reconnects
+ * on its own.
+ *
+ * @param backend Backend data structure containing the telemetry store
+ */
+static void push_telemetry_streams(struct backend_data_t *backend) {
+    pthread_mutex_lock(&telemetry_streams.lock);
+    if (telemetry_streams.count == 0) {
+        pthread_mutex_unlock(&telemetry_streams.lock);
+        return;
+    }
+
+    double now = get_wall_clock(&profile_context);
+    const struct telemetry_snapshot_t *snapshot = store_acquire_snapshot(backend->store);
+
+    for (int i = 0; i < telemetry_streams.count; i++) {
+        struct telemetry_stream_t *stream = &telemetry_streams.entries[i];
+        bool sent = send_stream_output(stream);
+        bool changed = false;
+
+        for (int dataset = 0; dataset < STORE_DATASET_COUNT && sent; dataset++) {
+            if ((stream->datasets & (1u << dataset)) && stream->sent_versions[dataset] != snapshot->versions[dataset]) {
+                sent = send_stream_event(stream, snapshot, dataset, backend->store->datasets[dataset].name, now);
+                changed = true;
+            }
         }
 
-        // Update simulation state based on the elapsed time
-        increment_simulation(backend);
+        // Comment lines are ignored by EventSource but fail to send once the browser is gone
+        if (sent && !changed && now - stream->last_send_time > TELEMETRY_STREAM_KEEPALIVE_SEC) {
+            const struct send_segment_t keepalive = {":\n\n", 3};
+            sent = send_stream_data(stream, &keepalive, 1);
+            changed = true;
+        }
 
-        // Sync simulation data to JSON files
-        sync_simulation_to_json(backend);
+        if (!sent) {
+            close_telemetry_stream(stream);
+            telemetry_streams.entries[i--] = telemetry_streams.entries[--telemetry_streams.count];
+            continue;
+        }
+        if (changed) {
+            stream->last_send_time = now;
+        }
+        request_stream_deltas(stream, backend->store);
     }
 
-    // Cleanup phase - shutdown server gracefully
-    printf("Clean up Database...\n");
-    cleanup_backend(backend);
+    store_release_snapshot(snapshot);
+    pthread_mutex_unlock(&telemetry_streams.lock);
+}
 
-    printf("Closing Sockets...\n");
-    CLOSESOCKET(server);
+/**
+ * Closes every open telemetry stream, called once the simulation thread has stopped.
+ */
+static void close_telemetry_streams(void) {
+    pthread_mutex_lock(&telemetry_streams.lock);
+    for (int i = 0; i < telemetry_streams.count; i++) {
+        close_telemetry_stream(&telemetry_streams.entries[i]);
+    }
+    telemetry_streams.count = 0;
+    pthread_mutex_unlock(&telemetry_streams.lock);
+}
 
-    // Windows specific socket close
-    #if defined(_WIN32)
-    #else
-        close(udp_socket);
-    #endif
+/**
+ * Unregisters a TCP client from the event loop, then closes and frees it.
+ */
+static void close_client(struct event_loop_t *loop, struct client_pool_t *clients,
+                         struct client_info_t *client) {
+    event_loop_remove(loop, client->socket);
+    drop_tcp_client(clients, client);
+}
 
-    printf("Cleaned up server listen sockets\n");
-    int leftover_clients = 0;
-    struct client_info_t *client = clients;
-    while (client) {
-        drop_tcp_client(&clients, client);
-        leftover_clients++;
-        client = client->next;
+/**
+ * Closes a TCP client once its last response is sent. A response that is still waiting for the socket is
+ * finished first, read_client closes the connection after it since keep_alive is cleared.
+ *
+ * @return false if the client was closed and must not be used anymore
+ */
+static bool close_client_after_response(struct event_loop_t *loop, struct client_pool_t *clients,
+                                        struct client_info_t *client) {
+    client->keep_alive = false;
+    if (has_pending_output(client)) {
+        event_loop_watch_writable(loop, client->socket, client, true);
+        return true;
     }
-    printf("Cleaned up %d client sockets\n", leftover_clients);
 
-    // Windows specific cleanup
-    #if defined(_WIN32)
-        WSACleanup();
-    #endif
+    close_client(loop, clients, client);
+    return false;
+}
 
-    printf("\nGoodbye World\n");
-    return 0;
+/**
+ * Closes keep-alive connections that have not sent anything for HTTP_KEEP_ALIVE_TIMEOUT_SEC.
+ */
+static void close_idle_clients(struct event_loop_t *loop, struct client_pool_t *clients) {
+    double now = get_wall_clock(&profile_context);
+    struct client_info_t *client = clients->open;
+
+    while (client) {
+        struct client_info_t *next = client->next;
+        if (now - client->last_request_time > HTTP_KEEP_ALIVE_TIMEOUT_SEC) {
+            close_client(loop, clients, client);
+        }
+        client = next;
+    }
 }
 
 /**
@@ -413,16 +1104,254 @@ static void get_contents(char *buffer, unsigned int *time, unsigned int *command
     }
 }
 
+/**
+ * Sends a UDP response, split into as many datagrams as needed. Every datagram starts with the
+ * 8 byte header (chunk index, chunk count, data version, big-endian) followed by up to
+ * UDP_RESPONSE_CHUNK_SIZE bytes of the payload, so clients can reassemble responses of any size.
+ * Pushed responses carry a prefix in front of the header, so subscribers can tell them apart.
+ *
+ * @param queue Queue the datagrams are added to
+ * @param address Destination address
+ * @param address_length Size of the destination address
+ * @param prefix Bytes sent in front of every datagram's header, NULL for a direct response
+ * @param prefix_length Size of the prefix in bytes, at most UDP_MESSAGE_INLINE_SIZE - UDP_RESPONSE_HEADER_SIZE
+ * @param payload Response payload, sent without copying so it has to stay valid until the queue is flushed
+ * @param payload_length Size of the payload in bytes
+ * @param version Version of the data in the payload, the same for every chunk of a response
+ */
+static void send_udp_response(struct udp_send_queue_t *queue, const struct sockaddr_in *address,
+                              socklen_t address_length, const unsigned char *prefix, size_t prefix_length,
+                              const void *payload, size_t payload_length, uint32_t version) {
+    size_t chunk_count = payload_length == 0 ? 1 : (payload_length + UDP_RESPONSE_CHUNK_SIZE - 1) / UDP_RESPONSE_CHUNK_SIZE;
+    if (chunk_count > UINT16_MAX) {
+        printf("UDP response of %lu bytes is too large to send\n", (unsigned long)payload_length);
+        return;
+    }
+
+    for (size_t i = 0; i < chunk_count; i++) {
+        unsigned char header[UDP_RESPONSE_HEADER_SIZE] = {
+            (i >> 8) & 0xFF, i & 0xFF,
+            (chunk_count >> 8) & 0xFF, chunk_count & 0xFF,
+            (version >> 24) & 0xFF, (version >> 16) & 0xFF, (version >> 8) & 0xFF, version & 0xFF
+        };
+
+        size_t offset = i * UDP_RESPONSE_CHUNK_SIZE;
+        size_t length = payload_length - offset;
+        if (length > UDP_RESPONSE_CHUNK_SIZE) {
+            length = UDP_RESPONSE_CHUNK_SIZE;
+        }
+
+        // Prefix and header are copied into the queued datagram, the payload is not
+        struct udp_message_t *message = queue_datagram(queue, address, address_length);
+        if (prefix != NULL) {
+            memcpy(message->inline_data, prefix, prefix_length);
+        }
+        memcpy(message->inline_data + prefix_length, header, sizeof(header));
+        message->segments[message->segment_count++] =
+            (struct send_segment_t){message->inline_data, prefix_length + sizeof(header)};
+        message->segments[message->segment_count++] =
+            (struct send_segment_t){(const unsigned char *)payload + offset, length};
+    }
+}
+
+/**
+ * Finds the delta a client that last received sent_version can be sent instead of the full document.
+ * Deltas only apply on top of the version they were built from, and a full keyframe is still sent every
+ * TELEMETRY_KEYFRAME_INTERVAL_SEC so clients recover from anything they missed.
+ *
+ * @return Delta from sent_version to the snapshot's version, or NULL to send the full document
+ */
+static const char *find_telemetry_delta(const struct telemetry_snapshot_t *snapshot, int dataset,
+                                        uint64_t sent_version, double last_keyframe_time, double now,
+                                        size_t *length) {
+    if (sent_version == 0 || now - last_keyframe_time >= TELEMETRY_KEYFRAME_INTERVAL_SEC) {
+        return NULL;
+    }
+    return store_snapshot_delta(snapshot, dataset, sent_version, length);
+}
+
+/**
+ * Reads a big-endian 32-bit value from a UDP payload
+ */
+static uint32_t read_udp_uint32(const char *data) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+/**
+ * Adds, renews, or removes the subscription of the device that sent a subscribe or unsubscribe command.
+ * Subscribe payload: bitmask of GET commands (uint32, bit n for command n), an optional minimum
+ * interval between pushes in milliseconds (uint32, defaults to every change), and optional flags
+ * (uint32, UDP_SUBSCRIBE_DELTAS to receive changed fields only between keyframes).
+ *
+ * @param packet Datagram and the sender's address
+ * @param command UDP_SUBSCRIBE_COMMAND or UDP_UNSUBSCRIBE_COMMAND
+ * @return true if the subscription was updated
+ */
+static bool update_udp_subscription(struct udp_packet_t *packet, unsigned int command) {
+    uint32_t commands = packet->length >= 12 ? read_udp_uint32(packet->data + 8) : 0;
+    uint32_t interval_ms = packet->length >= 16 ? read_udp_uint32(packet->data + 12) : 0;
+    uint32_t flags = packet->length >= 20 ? read_udp_uint32(packet->data + 16) : 0;
+
+    // Only keep commands that map to a dataset
+    for (int i = 0; i < UDP_SUBSCRIPTION_MAX_COMMANDS; i++) {
+        bool binary;
+        if ((commands & (1u << i)) && udp_get_command_dataset(i, &binary) < 0) {
+            commands &= ~(1u << i);
+        }
+    }
+
+    pthread_mutex_lock(&udp_subscriptions.lock);
+
+    int index = -1;
+    for (int i = 0; i < udp_subscriptions.count; i++) {
+        struct udp_subscription_t *entry = &udp_subscriptions.entries[i];
+        if (entry->address.sin_addr.s_addr == packet->address.sin_addr.s_addr &&
+            entry->address.sin_port == packet->address.sin_port) {
+            index = i;
+            break;
+        }
+    }
+
+    bool result = false;
+    if (command == UDP_UNSUBSCRIBE_COMMAND || commands == 0) {
+        // Remove the subscription by moving the last one into its place
+        if (index >= 0) {
+            udp_subscriptions.entries[index] = udp_subscriptions.entries[--udp_subscriptions.count];
+            result = command == UDP_UNSUBSCRIBE_COMMAND;
+        }
+    } else {
+        if (index < 0 && udp_subscriptions.count < MAX_UDP_SUBSCRIPTIONS) {
+            index = udp_subscriptions.count++;
+            memset(&udp_subscriptions.entries[index], 0, sizeof(struct udp_subscription_t));
+            udp_subscriptions.entries[index].address = packet->address;
+            udp_subscriptions.entries[index].address_length = packet->address_length;
+            char address[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &packet->address.sin_addr, address, sizeof(address));
+            printf("UDP subscription from %s:%d\n", address, ntohs(packet->address.sin_port));
+        }
+
+        if (index >= 0) {
+            struct udp_subscription_t *entry = &udp_subscriptions.entries[index];
+            entry->commands = commands;
+            entry->interval = interval_ms / 1000.0;
+            entry->deltas = (flags & UDP_SUBSCRIBE_DELTAS) != 0;
+            entry->lease_expires = get_wall_clock(&profile_context) + UDP_SUBSCRIPTION_LEASE_SEC;
+            result = true;
+        } else {
+            printf("Too many UDP subscriptions, ignoring subscribe command\n");
+        }
+    }
+
+    pthread_mutex_unlock(&udp_subscriptions.lock);
+    return result;
+}
+
+/**
+ * Pushes every subscribed GET response whose data changed since it was last pushed, at most once per
+ * subscription interval. All subscribers are served from the same snapshot, so each dataset is only
+ * serialized once per tick no matter how many clients are subscribed.
+ *
+ * @param queue Queue the pushed datagrams are added to, flushed before returning
+ * @param backend Backend data structure containing all telemetry and simulation engines
+ */
+static void push_udp_subscriptions(struct udp_send_queue_t *queue, struct backend_data_t *backend) {
+    pthread_mutex_lock(&udp_subscriptions.lock);
+    if (udp_subscriptions.count == 0) {
+        pthread_mutex_unlock(&udp_subscriptions.lock);
+        return;
+    }
+
+    double now = get_wall_clock(&profile_context);
+    const struct telemetry_snapshot_t *snapshot = store_acquire_snapshot(backend->store);
+
+    for (int i = 0; i < udp_subscriptions.count; i++) {
+        struct udp_subscription_t *entry = &udp_subscriptions.entries[i];
+
+        // Drop subscriptions that were not renewed in time, like the DUST heartbeat
+        if (now > entry->lease_expires) {
+            char address[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &entry->address.sin_addr, address, sizeof(address));
+            printf("UDP subscription from %s:%d expired\n", address, ntohs(entry->address.sin_port));
+            udp_subscriptions.entries[i--] = udp_subscriptions.entries[--udp_subscriptions.count];
+            continue;
+        }
+
+        for (int command = 0; command < UDP_SUBSCRIPTION_MAX_COMMANDS; command++) {
+            if (!(entry->commands & (1u << command))) continue;
+
+            bool binary;
+            int dataset = udp_get_command_dataset(command, &binary);
+            uint64_t version = snapshot->versions[dataset];
+            if (version == entry->pushed_versions[command] ||
+                now - entry->last_push_time[command] < entry->interval) {
+                continue;
+            }
+
+            // Prefix with the GET command, deltas also carry the version they apply to
+            uint32_t base_version = (uint32_t)entry->pushed_versions[command];
+            size_t delta_length = 0;
+            const char *delta_json = entry->deltas && !binary
+                                         ? find_telemetry_delta(snapshot, dataset, entry->pushed_versions[command],
+                                                                entry->last_keyframe_time[command], now,
+                                                                &delta_length)
+                                         : NULL;
+            bool delta = delta_json != NULL;
+            uint32_t prefix_command = delta ? ((uint32_t)command | UDP_PUSH_DELTA_FLAG) : (uint32_t)command;
+            unsigned char prefix[8] = {
+                (prefix_command >> 24) & 0xFF, (prefix_command >> 16) & 0xFF,
+                (prefix_command >> 8) & 0xFF, prefix_command & 0xFF,
+                (base_version >> 24) & 0xFF, (base_version >> 16) & 0xFF, (base_version >> 8) & 0xFF, base_version & 0xFF
+            };
+
+            if (binary) {
+                send_udp_response(queue, &entry->address, entry->address_length, prefix, 4,
+                                  snapshot->binary[dataset], snapshot->binary_length[dataset], (uint32_t)version);
+            } else if (delta) {
+                send_udp_response(queue, &entry->address, entry->address_length, prefix, 8,
+                                  delta_json, delta_length + 1, (uint32_t)version);
+            } else {
+                send_udp_response(queue, &entry->address, entry->address_length, prefix, 4,
+                                  snapshot->compact_json[dataset], snapshot->compact_length[dataset] + 1,
+                                  (uint32_t)version);
+                entry->last_keyframe_time[command] = now;
+            }
+
+            entry->pushed_versions[command] = version;
+            entry->last_push_time[command] = now;
+        }
+
+        // Subscribers on a longer interval than the tick get deltas spanning several publishes
+        if (entry->deltas) {
+            for (int command = 0; command < UDP_SUBSCRIPTION_MAX_COMMANDS; command++) {
+                if (!(entry->commands & (1u << command))) continue;
+
+                bool binary;
+                int dataset = udp_get_command_dataset(command, &binary);
+                if (!binary) {
+                    store_request_delta(backend->store, dataset, entry->pushed_versions[command]);
+                }
+            }
+        }
+    }
+
+    // The pushed payloads point into the snapshot
+    flush_datagrams(queue);
+    store_release_snapshot(snapshot);
+    pthread_mutex_unlock(&udp_subscriptions.lock);
+}
+
 /**
  * Sends telemetry data to Unreal Engine via UDP packets.
- * Transmits rover state (brakes, lights, steering, throttle, switch) as separate packets.
+ * Transmits rover state (brakes, lights, steering, throttle, switch) as separate packets, queued so they
+ * go out together when the caller flushes the queue.
  * 
- * @param socket UDP socket for transmission
+ * @param queue Queue the packets are added to
  * @param address Unreal Engine's network address
  * @param len Length of address structure
  * @param backend Backend data containing rover state
  */
-static void tss_to_unreal(SOCKET socket, struct sockaddr_in address, socklen_t len,
+static void tss_to_unreal(struct udp_send_queue_t *queue, struct sockaddr_in address, socklen_t len,
                           struct backend_data_t *backend) {
     // Extract current rover state from JSON file
     int brakes = (int)get_field_from_json("ROVER", "pr_telemetry.brakes", 0.0);
@@ -432,7 +1361,7 @@ static void tss_to_unreal(SOCKET socket, struct sockaddr_in address, socklen_t l
     int ping = (int)get_field_from_json("LTV", "signal.ping_requested", 0.0);
 
     unsigned int time = backend->server_up_time;
-    unsigned char buffer[12];
+    struct udp_message_t *message;
 
     // Convert packets to send in Big-Endian format
     if (!big_endian()) {
@@ -447,37 +1376,41 @@ static void tss_to_unreal(SOCKET socket, struct sockaddr_in address, socklen_t l
     unsigned int command = TSS_TO_UNREAL_BRAKES_COMMAND;
     if (!big_endian())
         reverse_bytes((unsigned char *)&command);
-    memcpy(buffer, &time, 4);
-    memcpy(buffer + 4, &command, 4);
-    memcpy(buffer + 8, &brakes, 4);
-    sendto(socket, buffer, sizeof(buffer), 0, (struct sockaddr *)&address, len);
+    message = queue_datagram(queue, &address, len);
+    memcpy(message->inline_data, &time, 4);
+    memcpy(message->inline_data + 4, &command, 4);
+    memcpy(message->inline_data + 8, &brakes, 4);
+    message->segments[message->segment_count++] = (struct send_segment_t){message->inline_data, 12};
 
     // Send lights command
     command = TSS_TO_UNREAL_LIGHTS_COMMAND;
     if (!big_endian())
         reverse_bytes((unsigned char *)&command);
-    memcpy(buffer, &time, 4);
-    memcpy(buffer + 4, &command, 4);
-    memcpy(buffer + 8, &lights_on, 4);
-    sendto(socket, buffer, sizeof(buffer), 0, (struct sockaddr *)&address, len);
+    message = queue_datagram(queue, &address, len);
+    memcpy(message->inline_data, &time, 4);
+    memcpy(message->inline_data + 4, &command, 4);
+    memcpy(message->inline_data + 8, &lights_on, 4);
+    message->segments[message->segment_count++] = (struct send_segment_t){message->inline_data, 12};
 
     // Send steering command
     command = TSS_TO_UNREAL_STEERING_COMMAND;
     if (!big_endian())
         reverse_bytes((unsigned char *)&command);
-    memcpy(buffer, &time, 4);
-    memcpy(buffer + 4, &command, 4);
-    memcpy(buffer + 8, &steering, 4);
-    sendto(socket, buffer, sizeof(buffer), 0, (struct sockaddr *)&address, len);
+    message = queue_datagram(queue, &address, len);
+    memcpy(message->inline_data, &time, 4);
+    memcpy(message->inline_data + 4, &command, 4);
+    memcpy(message->inline_data + 8, &steering, 4);
+    message->segments[message->segment_count++] = (struct send_segment_t){message->inline_data, 12};
 
     // Send throttle command
     command = TSS_TO_UNREAL_THROTTLE_COMMAND;
     if (!big_endian())
         reverse_bytes((unsigned char *)&command);
-    memcpy(buffer, &time, 4);
-    memcpy(buffer + 4, &command, 4);
-    memcpy(buffer + 8, &throttle, 4);
-    sendto(socket, buffer, sizeof(buffer), 0, (struct sockaddr *)&address, len);
+    message = queue_datagram(queue, &address, len);
+    memcpy(message->inline_data, &time, 4);
+    memcpy(message->inline_data + 4, &command, 4);
+    memcpy(message->inline_data + 8, &throttle, 4);
+    message->segments[message->segment_count++] = (struct send_segment_t){message->inline_data, 12};
 
     // Send ping to DUST only if it is true, then reset it and decrement pings left
     if (ping == true) {
@@ -485,10 +1418,11 @@ static void tss_to_unreal(SOCKET socket, struct sockaddr_in address, socklen_t l
         command = TSS_TO_UNREAL_PING_COMMAND;
         if (!big_endian())
             reverse_bytes((unsigned char *)&command);
-        memcpy(buffer, &time, 4);
-        memcpy(buffer + 4, &command, 4);
-        memcpy(buffer + 8, &ping, 4);
-        sendto(socket, buffer, sizeof(buffer), 0, (struct sockaddr *)&address, len);
+        message = queue_datagram(queue, &address, len);
+        memcpy(message->inline_data, &time, 4);
+        memcpy(message->inline_data + 4, &command, 4);
+        memcpy(message->inline_data + 8, &ping, 4);
+        message->segments[message->segment_count++] = (struct send_segment_t){message->inline_data, 12};
 
         printf("Ping requested, sending Unreal ping command\n");
         update_json_file("LTV", "signal", "ping_requested", "0");
@@ -5,7 +5,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "lib/cjson/cJSON.h"
 #include "network.h"
 #include "data.h"
@@ -19,8 +22,94 @@
 
 // Server Configuration
 #define UNREAL_UPDATE_INTERVAL_SEC 1.0
+#define SIMULATION_TICK_INTERVAL_MS 100 // how often the simulation thread advances and syncs the simulation
+#define DEFAULT_WORKER_THREADS 4        // I/O threads serving HTTP and UDP, overridden with --threads
+#define MAX_WORKER_THREADS 64
 
-#define LIDAR_NUM_POINTS 17 // number of LiDAR points expected from the DUST sim to allocate in memory
+// UDP responses, the 8 byte header holds the chunk index (uint16), chunk count (uint16), and data version (uint32)
+#define UDP_RESPONSE_HEADER_SIZE 8
+#define UDP_RESPONSE_CHUNK_SIZE 1400    // payload bytes per datagram, small enough that prefix, header, and payload fit one
+                                        // 1500 byte MTU, larger responses are split across datagrams
+#define UDP_GET_ENCODING_COMPACT 0      // optional GET input value, JSON without whitespace (default)
+#define UDP_GET_ENCODING_PRETTY 1       // optional GET input value, JSON formatted like the data files
+
+// UDP subscriptions, clients register to have GET responses pushed to them whenever the data changes
+#define UDP_SUBSCRIBE_COMMAND 3100
+#define UDP_UNSUBSCRIBE_COMMAND 3101
+#define UDP_SUBSCRIPTION_LEASE_SEC 10.0 // subscriptions expire unless renewed within this time
+#define UDP_SUBSCRIPTION_MAX_COMMANDS 32 // GET commands that can be subscribed to, one bit each
+#define MAX_UDP_SUBSCRIPTIONS 64
+#define UDP_SUBSCRIBE_DELTAS 1           // subscribe flag, push changed fields only between keyframes
+#define UDP_PUSH_DELTA_FLAG 0x80000000u  // set in the command prefix of pushed deltas
+
+// Clients receiving deltas still get the full document this often, so missed updates are repaired
+#define TELEMETRY_KEYFRAME_INTERVAL_SEC 5.0
+
+// Server-Sent Events stream at /stream, pushes dataset updates to the web interface over one connection
+#define TELEMETRY_STREAM_PATH "/stream"
+#define MAX_TELEMETRY_STREAMS 64
+#define TELEMETRY_STREAM_KEEPALIVE_SEC 15.0 // idle streams get a comment line so dead connections are noticed
+#define TELEMETRY_STREAM_MAX_BACKLOG (256 * 1024) // unsent bytes a stream can hold before it is dropped as too slow
+
+// I/O worker, each one owns its own listening sockets, event loop, and client list
+struct server_worker_t {
+    int index;
+    pthread_t thread;
+    SOCKET server;
+    SOCKET udp_socket;
+    struct event_loop_t loop;
+    struct client_pool_t clients;
+    struct udp_packet_t* udp_packets;   // UDP_BATCH_SIZE receive buffers, reused for every batch of datagrams
+    struct backend_data_t* backend;
+};
+
+// DUST (Unreal Engine) connection, set by whichever worker receives the heartbeat and read by the simulation thread
+struct unreal_link_t {
+    pthread_mutex_t lock;
+    struct sockaddr_in address;
+    socklen_t address_length;
+    bool connected;
+    double last_message_time;
+};
+
+// Client subscribed to server-pushed telemetry, set by the workers and served by the simulation thread
+struct udp_subscription_t {
+    struct sockaddr_in address;
+    socklen_t address_length;
+    uint32_t commands;                                      // bit n is set for every GET command n to push
+    double interval;                                        // minimum seconds between pushes of one command
+    bool deltas;                                            // push JSON merge patches between keyframes
+    double lease_expires;
+    double last_push_time[UDP_SUBSCRIPTION_MAX_COMMANDS];
+    uint64_t pushed_versions[UDP_SUBSCRIPTION_MAX_COMMANDS]; // data version last pushed, 0 before the first push
+    double last_keyframe_time[UDP_SUBSCRIPTION_MAX_COMMANDS];
+};
+
+struct udp_subscriptions_t {
+    pthread_mutex_t lock;
+    struct udp_subscription_t entries[MAX_UDP_SUBSCRIPTIONS];
+    int count;
+};
+
+// Browser connected to the telemetry stream, handed over from its worker to the simulation thread
+struct telemetry_stream_t {
+    SOCKET socket;
+    uint32_t datasets;                            // bit n is set for every store dataset n to send
+    uint64_t sent_versions[STORE_DATASET_COUNT];  // dataset version last sent, 0 before the first event
+    double last_keyframe_time[STORE_DATASET_COUNT];
+    bool deltas;                                  // send JSON merge patches between keyframes
+    double last_send_time;
+    char *output;                                 // event bytes the socket didn't take yet, sent before anything new
+    size_t output_length;
+    size_t output_offset;                         // bytes of output already sent
+    size_t output_capacity;
+};
+
+struct telemetry_streams_t {
+    pthread_mutex_t lock;
+    struct telemetry_stream_t entries[MAX_TELEMETRY_STREAMS];
+    int count;
+};
 
 extern struct profile_context_t profile_context;
 
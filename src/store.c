@@ -0,0 +1,1219 @@
+// store.c - resident telemetry store holding the EVA, ROVER and LTV datasets in memory
+
+#include "store.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include "lib/gzip/gzip.h"
+
+static const char* dataset_names[STORE_DATASET_COUNT] = {"EVA", "ROVER", "LTV"};
+
+#define STORE_INITIAL_SLOT_TABLE_SIZE 512
+#define STORE_MAX_PATH_LENGTH 256
+
+static void register_slots(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* object,
+                           char* path, size_t length);
+
+///////////////////////////////////////////////////////////////////////////////////
+//                              Store Lifecycle
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Reads and parses a single dataset file from the data folder.
+ *
+ * @param name Dataset name without extension (e.g., "EVA")
+ * @return Parsed JSON document, or an empty object if the file is missing or invalid
+ */
+static cJSON* load_dataset_file(const char* name) {
+    char file_path[100];
+    snprintf(file_path, sizeof(file_path), STORE_DATA_ROOT "/%s.json", name);
+
+    FILE* fp = fopen(file_path, "r");
+    if (fp == NULL) {
+        printf("Error: Unable to open the file %s for reading.\n", file_path);
+        return cJSON_CreateObject();
+    }
+
+    fseek(fp, 0L, SEEK_END);
+    long file_size = ftell(fp);
+    rewind(fp);
+
+    char* file_buffer = malloc(file_size + 1);
+    if (!file_buffer) {
+        fclose(fp);
+        return cJSON_CreateObject();
+    }
+    size_t bytes_read = fread(file_buffer, 1, file_size, fp);
+    file_buffer[bytes_read] = '\0';
+    fclose(fp);
+
+    cJSON* json = cJSON_Parse(file_buffer);
+    free(file_buffer);
+
+    if (json == NULL) {
+        printf("Error: Failed to parse JSON from file %s., check data folder for existing files. Accidental edits to those files can be resolved with git checkout data\n", file_path);
+        return cJSON_CreateObject();
+    }
+
+    return json;
+}
+
+/**
+ * Creates the telemetry store and loads every dataset from the data folder into memory.
+ * After this point the in-memory copy is authoritative and the files are only a persisted view.
+ *
+ * @return Pointer to the new store, or NULL if allocation failed
+ */
+struct telemetry_store_t* store_create(void) {
+    struct telemetry_store_t* store = calloc(1, sizeof(struct telemetry_store_t));
+    if (!store) return NULL;
+
+    // Data helpers call into each other, so the store lock has to be re-entrant
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&store->lock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+
+    pthread_mutex_init(&store->flusher_mutex, NULL);
+    pthread_cond_init(&store->flusher_wake, NULL);
+    store->flush_interval_ms = STORE_DEFAULT_FLUSH_INTERVAL_MS;
+
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        struct telemetry_dataset_t* dataset = &store->datasets[i];
+        dataset->name = dataset_names[i];
+        dataset->root = load_dataset_file(dataset->name);
+        dataset->version = 1;
+        dataset->persisted_version = 1;
+    }
+
+    // Resolve every path in the loaded documents up front
+    store->slot_table_size = STORE_INITIAL_SLOT_TABLE_SIZE;
+    store->slot_table = malloc(store->slot_table_size * sizeof(int));
+    for (int i = 0; i < store->slot_table_size; i++) {
+        store->slot_table[i] = STORE_INVALID_HANDLE;
+    }
+    store->node_table_size = STORE_INITIAL_SLOT_TABLE_SIZE;
+    store->node_table = malloc(store->node_table_size * sizeof(int));
+    for (int i = 0; i < store->node_table_size; i++) {
+        store->node_table[i] = STORE_INVALID_HANDLE;
+    }
+
+    char path[STORE_MAX_PATH_LENGTH];
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        register_slots(store, i, store->datasets[i].root, path, 0);
+    }
+
+    // Readers always find a complete snapshot, even before the simulation publishes its first one
+    store_publish_snapshot(store);
+
+    return store;
+}
+
+/**
+ * Frees the telemetry store and all of the resident datasets.
+ *
+ * @param store Store to destroy
+ */
+void store_destroy(struct telemetry_store_t* store) {
+    if (!store) return;
+
+    store_stop_flusher(store);
+
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        cJSON_Delete(store->datasets[i].root);
+    }
+
+    for (int i = 0; i < store->slot_count; i++) {
+        free(store->slots[i].path);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < STORE_DATASET_COUNT; j++) {
+            free(store->snapshots[i].json[j]);
+            free(store->snapshots[i].compact_json[j]);
+            free(store->snapshots[i].binary[j]);
+            free(store->snapshots[i].gzip_json[j]);
+            for (int k = 0; k < store->snapshots[i].delta_count[j]; k++) {
+                free(store->snapshots[i].delta_json[j][k]);
+            }
+        }
+    }
+    free(store->slots);
+    free(store->slot_table);
+    free(store->node_table);
+
+    pthread_cond_destroy(&store->flusher_wake);
+    pthread_mutex_destroy(&store->flusher_mutex);
+    pthread_mutex_destroy(&store->lock);
+    free(store);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Locking
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Acquires the store lock. Every access to the resident documents has to happen while holding it,
+ * the lock is re-entrant so nested data helpers can take it again.
+ */
+void store_lock(struct telemetry_store_t* store) {
+    pthread_mutex_lock(&store->lock);
+}
+
+/**
+ * Releases the store lock taken with store_lock.
+ */
+void store_unlock(struct telemetry_store_t* store) {
+    pthread_mutex_unlock(&store->lock);
+}
+
+/**
+ * Takes the store lock for a group of writes that readers should only ever see together. Snapshots can't be
+ * published while the lock is held, and each changed dataset gets one version bump when the batch ends, so
+ * the whole group is serialized, pushed to subscribers, and written to disk once.
+ */
+void store_begin_batch(struct telemetry_store_t* store) {
+    store_lock(store);
+    store->batch_depth++;
+}
+
+/**
+ * Ends a batch started with store_begin_batch and releases the store lock.
+ */
+void store_end_batch(struct telemetry_store_t* store) {
+    if (--store->batch_depth == 0) {
+        for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+            if (store->batch_modified & (1u << i)) {
+                store->datasets[i].version++;
+            }
+        }
+        store->batch_modified = 0;
+    }
+    store_unlock(store);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                   Lookup
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Maps a file or route name to its dataset, accepting "EVA", "eva", or "EVA.json".
+ *
+ * @param name Name of the dataset
+ * @return Dataset index, or -1 if the name is not recognized
+ */
+int store_dataset_from_name(const char* name) {
+    if (!name) return -1;
+
+    size_t length = strcspn(name, ".");
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        if (strlen(dataset_names[i]) == length && strncasecmp(name, dataset_names[i], length) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Returns the resident root object of a dataset. The store keeps ownership.
+ */
+cJSON* store_get_root(struct telemetry_store_t* store, store_dataset_t dataset) {
+    if (!store || dataset < 0 || dataset >= STORE_DATASET_COUNT) return NULL;
+    return store->datasets[dataset].root;
+}
+
+/**
+ * Walks a dot-separated path (e.g., "pr_telemetry.brakes") starting at the given object.
+ * Path segments are compared in place, so the path string is never copied or modified.
+ *
+ * @param object Object to start the lookup from
+ * @param path Dot-separated path relative to the object
+ * @return Matching item, or NULL if any segment is missing
+ */
+cJSON* store_find_path(cJSON* object, const char* path) {
+    if (!object || !path) return NULL;
+
+    const char* segment = path;
+    while (object && *segment) {
+        size_t length = strcspn(segment, ".");
+
+        cJSON* child = NULL;
+        cJSON_ArrayForEach(child, object) {
+            if (child->string && strncmp(child->string, segment, length) == 0 &&
+                child->string[length] == '\0') {
+                break;
+            }
+        }
+        object = child;
+
+        segment += length;
+        if (*segment == '.') segment++;
+    }
+
+    return object;
+}
+
+/**
+ * Finds an item inside a dataset by dot-separated path, using the slot table so repeated lookups are O(1).
+ */
+cJSON* store_find(struct telemetry_store_t* store, store_dataset_t dataset, const char* path) {
+    return store_handle_node(store, store_resolve(store, dataset, path));
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Handles
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * FNV-1a hash of a dataset relative path, the dataset is mixed in so equal paths in different datasets differ.
+ */
+static uint32_t hash_path(store_dataset_t dataset, const char* path, size_t length) {
+    uint32_t hash = 2166136261u ^ (uint32_t)dataset;
+    hash *= 16777619u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)path[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Looks up a path in the slot table.
+ *
+ * @return Slot index, or STORE_INVALID_HANDLE if the path has not been registered
+ */
+static store_handle_t find_slot(struct telemetry_store_t* store, store_dataset_t dataset, const char* path,
+                                size_t length, uint32_t hash) {
+    int mask = store->slot_table_size - 1;
+    for (int i = hash & mask; store->slot_table[i] != STORE_INVALID_HANDLE; i = (i + 1) & mask) {
+        struct telemetry_slot_t* slot = &store->slots[store->slot_table[i]];
+        if (slot->hash == hash && slot->dataset == dataset && strncmp(slot->path, path, length) == 0 &&
+            slot->path[length] == '\0') {
+            return store->slot_table[i];
+        }
+    }
+    return STORE_INVALID_HANDLE;
+}
+
+/**
+ * Places a slot index into the hash table, the table must have a free entry.
+ */
+static void insert_slot_index(struct telemetry_store_t* store, store_handle_t handle) {
+    int mask = store->slot_table_size - 1;
+    int i = store->slots[handle].hash & mask;
+    while (store->slot_table[i] != STORE_INVALID_HANDLE) {
+        i = (i + 1) & mask;
+    }
+    store->slot_table[i] = handle;
+}
+
+/**
+ * Hash of an item address for the node table, the low bits are always zero because of alignment.
+ */
+static uint32_t hash_node(const cJSON* node) {
+    return (uint32_t)(((uintptr_t)node >> 4) * 2654435761u);
+}
+
+/**
+ * Indexes a slot by the item it points to, so a setter given only the item can record which path changed.
+ * Entries are never removed, a slot that moved to another item leaves a stale entry that lookups skip,
+ * and the table is rebuilt from the slots once it is half full.
+ */
+static void insert_node_index(struct telemetry_store_t* store, store_handle_t handle) {
+    if ((store->node_table_used + 1) * 2 > store->node_table_size) {
+        int bound = 0;
+        for (int i = 0; i < store->slot_count; i++) {
+            if (store->slots[i].node) bound++;
+        }
+
+        // Only grow when the live entries alone would fill it, otherwise dropping the stale ones is enough
+        int size = (bound + 1) * 4 > store->node_table_size ? store->node_table_size * 2 : store->node_table_size;
+        int* table = malloc(size * sizeof(int));
+        if (!table) return;
+
+        free(store->node_table);
+        store->node_table = table;
+        store->node_table_size = size;
+        store->node_table_used = 0;
+        for (int i = 0; i < size; i++) {
+            store->node_table[i] = STORE_INVALID_HANDLE;
+        }
+        for (int i = 0; i < store->slot_count; i++) {
+            if (store->slots[i].node && i != handle) {
+                insert_node_index(store, i);
+            }
+        }
+    }
+
+    int mask = store->node_table_size - 1;
+    int i = hash_node(store->slots[handle].node) & mask;
+    while (store->node_table[i] != STORE_INVALID_HANDLE) {
+        i = (i + 1) & mask;
+    }
+    store->node_table[i] = handle;
+    store->node_table_used++;
+}
+
+/**
+ * Finds the slot that currently points to an item.
+ *
+ * @return Slot index, or STORE_INVALID_HANDLE if no slot points to the item
+ */
+static store_handle_t find_node_slot(struct telemetry_store_t* store, const cJSON* node) {
+    int mask = store->node_table_size - 1;
+    for (int i = hash_node(node) & mask; store->node_table[i] != STORE_INVALID_HANDLE; i = (i + 1) & mask) {
+        if (store->slots[store->node_table[i]].node == node) {
+            return store->node_table[i];
+        }
+    }
+    return STORE_INVALID_HANDLE;
+}
+
+/**
+ * Appends a slot for a path and indexes it, growing the slot array and hash table as needed.
+ *
+ * @return Handle of the new slot, or STORE_INVALID_HANDLE if allocation failed
+ */
+static store_handle_t add_slot(struct telemetry_store_t* store, store_dataset_t dataset, const char* path,
+                               size_t length, uint32_t hash, cJSON* node) {
+    if (store->slot_count == store->slot_capacity) {
+        int capacity = store->slot_capacity ? store->slot_capacity * 2 : 256;
+        struct telemetry_slot_t* slots = realloc(store->slots, capacity * sizeof(struct telemetry_slot_t));
+        if (!slots) return STORE_INVALID_HANDLE;
+        store->slots = slots;
+        store->slot_capacity = capacity;
+    }
+
+    // Keep the table at most half full so probes stay short
+    if ((store->slot_count + 1) * 2 > store->slot_table_size) {
+        int* table = malloc(store->slot_table_size * 2 * sizeof(int));
+        if (!table) return STORE_INVALID_HANDLE;
+
+        free(store->slot_table);
+        store->slot_table = table;
+        store->slot_table_size *= 2;
+        for (int i = 0; i < store->slot_table_size; i++) {
+            store->slot_table[i] = STORE_INVALID_HANDLE;
+        }
+        for (int i = 0; i < store->slot_count; i++) {
+            insert_slot_index(store, i);
+        }
+    }
+
+    struct telemetry_slot_t* slot = &store->slots[store->slot_count];
+    slot->dataset = dataset;
+    slot->path = strndup(path, length);
+    slot->hash = hash;
+    slot->node = node;
+    slot->changed_version = 0;
+
+    insert_slot_index(store, store->slot_count);
+    if (node) {
+        insert_node_index(store, store->slot_count);
+    }
+    return store->slot_count++;
+}
+
+/**
+ * Registers a slot for every item below an object, so the paths that exist at startup never have to be walked.
+ * Arrays are registered as a single slot (e.g. LiDAR), their elements are not addressable by path.
+ *
+ * @param store Store to register the slots in
+ * @param dataset Dataset the object belongs to
+ * @param object Object whose children are registered
+ * @param path Buffer holding the path of the object, extended in place for each child
+ * @param length Length of the object's path inside the buffer
+ */
+static void register_slots(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* object,
+                           char* path, size_t length) {
+    cJSON* child = NULL;
+    cJSON_ArrayForEach(child, object) {
+        if (!child->string) continue;
+
+        int written = snprintf(path + length, STORE_MAX_PATH_LENGTH - length, "%s%s", length ? "." : "",
+                               child->string);
+        if (written < 0 || length + written >= STORE_MAX_PATH_LENGTH) continue;
+
+        size_t child_length = length + written;
+        uint32_t hash = hash_path(dataset, path, child_length);
+        if (find_slot(store, dataset, path, child_length, hash) == STORE_INVALID_HANDLE) {
+            add_slot(store, dataset, path, child_length, hash, child);
+        }
+
+        if (cJSON_IsObject(child)) {
+            register_slots(store, dataset, child, path, child_length);
+        }
+    }
+    path[length] = '\0';
+}
+
+/**
+ * Resolves a dot-separated path inside a dataset to a handle. Paths that were present at startup are found
+ * in the slot table, items added later are walked once and registered.
+ *
+ * @param store Store to resolve the path in
+ * @param dataset Dataset to look in
+ * @param path Dataset relative path (e.g., "pr_telemetry.brakes")
+ * @return Handle to the item, or STORE_INVALID_HANDLE if the path does not exist
+ */
+store_handle_t store_resolve(struct telemetry_store_t* store, store_dataset_t dataset, const char* path) {
+    if (!store || !path || dataset < 0 || dataset >= STORE_DATASET_COUNT) return STORE_INVALID_HANDLE;
+
+    size_t length = strlen(path);
+    uint32_t hash = hash_path(dataset, path, length);
+
+    store_lock(store);
+    store_handle_t handle = find_slot(store, dataset, path, length, hash);
+    if (handle == STORE_INVALID_HANDLE) {
+        cJSON* node = store_find_path(store->datasets[dataset].root, path);
+        if (node) {
+            handle = add_slot(store, dataset, path, length, hash, node);
+        }
+    }
+    store_unlock(store);
+
+    return handle;
+}
+
+/**
+ * Resolves a route that starts with the dataset name (e.g., "rover.pr_telemetry.brakes") to a handle.
+ *
+ * @return Handle to the item, or STORE_INVALID_HANDLE if the dataset or path does not exist
+ */
+store_handle_t store_resolve_route(struct telemetry_store_t* store, const char* route) {
+    const char* path = route ? strchr(route, '.') : NULL;
+    if (!path) return STORE_INVALID_HANDLE;
+
+    return store_resolve(store, store_dataset_from_name(route), path + 1);
+}
+
+/**
+ * Returns the item a handle refers to, looking the path up again if the item was replaced.
+ */
+cJSON* store_handle_node(struct telemetry_store_t* store, store_handle_t handle) {
+    if (!store || handle < 0 || handle >= store->slot_count) return NULL;
+
+    struct telemetry_slot_t* slot = &store->slots[handle];
+    if (slot->node == NULL) {
+        slot->node = store_find_path(store->datasets[slot->dataset].root, slot->path);
+        if (slot->node) {
+            insert_node_index(store, handle);
+        }
+    }
+    return slot->node;
+}
+
+/**
+ * Returns the dataset a handle belongs to.
+ */
+store_dataset_t store_handle_dataset(struct telemetry_store_t* store, store_handle_t handle) {
+    return store->slots[handle].dataset;
+}
+
+/**
+ * Reads a numeric value through a handle, booleans are returned as 1.0 or 0.0.
+ *
+ * @return true if the item exists and is a number or boolean
+ */
+bool store_handle_get_number(struct telemetry_store_t* store, store_handle_t handle, double* value) {
+    cJSON* node = store_handle_node(store, handle);
+
+    if (cJSON_IsNumber(node)) {
+        *value = node->valuedouble;
+        return true;
+    } else if (cJSON_IsBool(node)) {
+        *value = cJSON_IsTrue(node) ? 1.0 : 0.0;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Sets a numeric value through a handle.
+ *
+ * @return true if the value changed
+ */
+bool store_handle_set_number(struct telemetry_store_t* store, store_handle_t handle, double value) {
+    cJSON* node = store_handle_node(store, handle);
+    return node && store_set_number(store, store->slots[handle].dataset, node, value);
+}
+
+/**
+ * Sets a boolean value through a handle.
+ *
+ * @return true if the value changed
+ */
+bool store_handle_set_bool(struct telemetry_store_t* store, store_handle_t handle, bool value) {
+    cJSON* node = store_handle_node(store, handle);
+    return node && store_set_bool(store, store->slots[handle].dataset, node, value);
+}
+
+/**
+ * Sets a value from its string representation through a handle, see store_set_from_string.
+ *
+ * @return true if the value changed
+ */
+bool store_handle_set_from_string(struct telemetry_store_t* store, store_handle_t handle, const char* value) {
+    cJSON* node = store_handle_node(store, handle);
+    return node && store_set_from_string(store, store->slots[handle].dataset, node, value);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Mutation
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Records that a dataset changed so that readers and the persistence layer can pick it up. The slot of the
+ * changed item is stamped with the version the change becomes visible in, deltas are built from the stamps.
+ *
+ * @param store Store that changed
+ * @param dataset Dataset that changed
+ * @param node Item whose value changed, NULL when items were added, which no slot can record
+ */
+static void mark_modified(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* node) {
+    struct telemetry_dataset_t* data = &store->datasets[dataset];
+
+    // A batch bumps the version once when it ends
+    uint64_t version = data->version + 1;
+    if (store->batch_depth > 0) {
+        store->batch_modified |= 1u << dataset;
+    } else {
+        data->version = version;
+    }
+
+    store_handle_t handle = node ? find_node_slot(store, node) : STORE_INVALID_HANDLE;
+    if (handle != STORE_INVALID_HANDLE) {
+        store->slots[handle].changed_version = version;
+    } else {
+        data->untracked_version = version;
+    }
+}
+
+/**
+ * Drops the cached item of every slot that points into a subtree that is about to be deleted.
+ * Only happens when an object is overwritten with a plain value, so a linear scan is fine.
+ */
+static void unbind_slots(struct telemetry_store_t* store, cJSON* object) {
+    cJSON* child = NULL;
+    cJSON_ArrayForEach(child, object) {
+        for (int i = 0; i < store->slot_count; i++) {
+            if (store->slots[i].node == child) {
+                store->slots[i].node = NULL;
+            }
+        }
+        if (cJSON_IsObject(child)) {
+            unbind_slots(store, child);
+        }
+    }
+}
+
+/**
+ * Releases whatever value an item currently holds so its type can be changed in place.
+ * Items are always updated in place to keep pointers into the store stable.
+ */
+static void clear_node_value(struct telemetry_store_t* store, cJSON* node) {
+    if ((node->type & 0xFF) == cJSON_String && node->valuestring && !(node->type & cJSON_IsReference)) {
+        free(node->valuestring);
+    }
+    node->valuestring = NULL;
+
+    if (((node->type & 0xFF) == cJSON_Array || (node->type & 0xFF) == cJSON_Object) && node->child) {
+        if ((node->type & 0xFF) == cJSON_Object) {
+            unbind_slots(store, node);
+        }
+        cJSON_Delete(node->child);
+    }
+    node->child = NULL;
+}
+
+/**
+ * Sets a numeric value on an existing item.
+ *
+ * @return true if the value changed
+ */
+bool store_set_number(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* node, double value) {
+    if (!store || !node) return false;
+
+    if (cJSON_IsNumber(node) && node->valuedouble == value) {
+        return false;
+    }
+
+    clear_node_value(store, node);
+    node->type = cJSON_Number | (node->type & cJSON_StringIsConst);
+    cJSON_SetNumberValue(node, value);
+
+    mark_modified(store, dataset, node);
+    return true;
+}
+
+/**
+ * Sets a boolean value on an existing item.
+ *
+ * @return true if the value changed
+ */
+bool store_set_bool(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* node, bool value) {
+    if (!store || !node) return false;
+
+    if (cJSON_IsBool(node) && cJSON_IsTrue(node) == value) {
+        return false;
+    }
+
+    clear_node_value(store, node);
+    node->type = (value ? cJSON_True : cJSON_False) | (node->type & cJSON_StringIsConst);
+
+    mark_modified(store, dataset, node);
+    return true;
+}
+
+/**
+ * Replaces the contents of an array item with a list of numbers (used for LiDAR).
+ *
+ * @return true if the array changed
+ */
+bool store_set_number_array(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* node,
+                            const double* values, int count) {
+    if (!store || !node || (count > 0 && !values)) return false;
+
+    if (cJSON_IsArray(node) && cJSON_GetArraySize(node) == count) {
+        bool same = true;
+        int i = 0;
+        cJSON* item = NULL;
+        cJSON_ArrayForEach(item, node) {
+            if (!cJSON_IsNumber(item) || item->valuedouble != values[i++]) {
+                same = false;
+                break;
+            }
+        }
+        if (same) return false;
+    }
+
+    clear_node_value(store, node);
+    node->type = cJSON_Array | (node->type & cJSON_StringIsConst);
+    for (int i = 0; i < count; i++) {
+        cJSON_AddItemToArray(node, cJSON_CreateNumber(values[i]));
+    }
+
+    mark_modified(store, dataset, node);
+    return true;
+}
+
+/**
+ * Sets a value from its string representation, using the same rules the HTML form and UDP paths
+ * have always used: "true"/"false" become booleans, "[1.0,2.0]" becomes a number array, numeric
+ * strings become numbers, and anything else is stored as a string.
+ *
+ * @return true if the value changed
+ */
+bool store_set_from_string(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* node,
+                           const char* value) {
+    if (!store || !node || !value) return false;
+
+    if (strcmp(value, "true") == 0) {
+        return store_set_bool(store, dataset, node, true);
+    }
+    if (strcmp(value, "false") == 0) {
+        return store_set_bool(store, dataset, node, false);
+    }
+
+    if (value[0] == '[') {
+        double values[64];
+        int count = 0;
+        const char* cursor = value + 1;
+        while (*cursor && *cursor != ']' && count < 64) {
+            char* end = NULL;
+            values[count] = strtod(cursor, &end);
+            if (end == cursor) break;
+            count++;
+            cursor = end;
+            while (*cursor == ',' || *cursor == ' ') cursor++;
+        }
+        return store_set_number_array(store, dataset, node, values, count);
+    }
+
+    char* endptr;
+    double number = strtod(value, &endptr);
+    if (*value != '\0' && *endptr == '\0') {
+        return store_set_number(store, dataset, node, number);
+    }
+
+    if (cJSON_IsString(node) && strcmp(node->valuestring, value) == 0) {
+        return false;
+    }
+
+    clear_node_value(store, node);
+    node->type = cJSON_String | (node->type & cJSON_StringIsConst);
+    node->valuestring = strdup(value);
+
+    mark_modified(store, dataset, node);
+    return true;
+}
+
+/**
+ * Adds a new numeric item to an object in the store.
+ *
+ * @return The newly created item
+ */
+cJSON* store_add_number(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* object,
+                        const char* name, double value) {
+    if (!store || !object || !name) return NULL;
+
+    cJSON* item = cJSON_AddNumberToObject(object, name, value);
+    if (item) {
+        mark_modified(store, dataset, NULL);
+    }
+
+    return item;
+}
+
+/**
+ * Returns the object with the given name inside a parent object, creating it if it is missing.
+ *
+ * @return The existing or newly created object
+ */
+cJSON* store_get_or_add_object(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* parent,
+                               const char* name) {
+    if (!store || !parent || !name) return NULL;
+
+    cJSON* object = cJSON_GetObjectItemCaseSensitive(parent, name);
+    if (object == NULL) {
+        object = cJSON_AddObjectToObject(parent, name);
+        if (object) {
+            mark_modified(store, dataset, NULL);
+        }
+    }
+
+    return object;
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                 Snapshots
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Adds the current value of a changed item to a merge patch under its dot-separated path, creating the
+ * objects above it. An item below something that was replaced as a whole is already covered by it.
+ */
+static void add_delta_item(cJSON* delta, const char* path, const cJSON* node) {
+    char buffer[STORE_MAX_PATH_LENGTH];
+    snprintf(buffer, sizeof(buffer), "%s", path);
+
+    cJSON* parent = delta;
+    char* name = buffer;
+    char* dot;
+    while ((dot = strchr(name, '.')) != NULL) {
+        *dot = '\0';
+        cJSON* child = cJSON_GetObjectItemCaseSensitive(parent, name);
+        if (child == NULL) {
+            child = cJSON_AddObjectToObject(parent, name);
+        } else if (!cJSON_IsObject(child)) {
+            return;
+        }
+        if (child == NULL) return;
+        parent = child;
+        name = dot + 1;
+    }
+
+    // An item that no longer exists is removed with null
+    cJSON* value = node ? cJSON_Duplicate(node, true) : cJSON_CreateNull();
+    if (value == NULL) return;
+    if (cJSON_GetObjectItemCaseSensitive(parent, name)) {
+        cJSON_ReplaceItemInObjectCaseSensitive(parent, name, value);
+    } else {
+        cJSON_AddItemToObject(parent, name, value);
+    }
+}
+
+/**
+ * Builds a compact JSON merge patch (RFC 7386) that turns a dataset as of base_version into its current
+ * state, from the slots stamped with a later version. Only the changed items are visited and copied.
+ *
+ * @return malloc'd patch, or NULL if the dataset had a change since base_version that no slot recorded
+ */
+static char* build_delta(struct telemetry_store_t* store, store_dataset_t dataset, uint64_t base_version) {
+    if (store->datasets[dataset].untracked_version > base_version) {
+        return NULL;
+    }
+
+    cJSON* delta = cJSON_CreateObject();
+    if (delta == NULL) return NULL;
+
+    for (int i = 0; i < store->slot_count; i++) {
+        struct telemetry_slot_t* slot = &store->slots[i];
+        if (slot->dataset == dataset && slot->changed_version > base_version) {
+            add_delta_item(delta, slot->path, store_handle_node(store, i));
+        }
+    }
+
+    char* delta_str = cJSON_PrintUnformatted(delta);
+    cJSON_Delete(delta);
+    return delta_str;
+}
+
+/**
+ * Publishes the current state of every dataset as a new snapshot. Only datasets whose version changed are
+ * serialized again, the rest are carried over from the active snapshot. Deltas are built for the versions
+ * readers asked for with store_request_delta since the last publish, and skipped when nobody asked.
+ *
+ * The snapshot that is not active is rebuilt and then swapped in. If a reader still holds it from an
+ * earlier publish the call returns without waiting, the next publish picks the changes up.
+ *
+ * @param store Store to publish
+ * @return true if a new snapshot was published or nothing changed, false if publishing has to be retried
+ */
+bool store_publish_snapshot(struct telemetry_store_t* store) {
+    if (!store) return false;
+
+    store_lock(store);
+
+    int active = atomic_load(&store->active_snapshot);
+    struct telemetry_snapshot_t* current = &store->snapshots[active];
+    struct telemetry_snapshot_t* next = &store->snapshots[1 - active];
+
+    bool changed = false;
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        if (current->json[i] == NULL || current->versions[i] != store->datasets[i].version) {
+            changed = true;
+        }
+    }
+
+    // Deferred reclamation, the inactive snapshot is only reused once its last reader has released it
+    if (!changed || atomic_load(&next->readers) != 0) {
+        store_unlock(store);
+        return !changed;
+    }
+
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        uint64_t version = store->datasets[i].version;
+        if (next->json[i] != NULL && next->versions[i] == version) {
+            continue;
+        }
+
+        char* json_str = NULL;
+        char* compact_str = NULL;
+        if (current->json[i] != NULL && current->versions[i] == version) {
+            json_str = strdup(current->json[i]);
+            compact_str = strdup(current->compact_json[i]);
+        } else {
+            json_str = cJSON_Print(store->datasets[i].root);
+            compact_str = cJSON_PrintUnformatted(store->datasets[i].root);
+        }
+        if (json_str == NULL || compact_str == NULL) {
+            printf("Error: Failed to serialize %s for the snapshot\n", store->datasets[i].name);
+            free(json_str);
+            free(compact_str);
+            continue;
+        }
+
+        free(next->json[i]);
+        next->json[i] = json_str;
+        next->json_length[i] = strlen(json_str);
+        free(next->compact_json[i]);
+        next->compact_json[i] = compact_str;
+        next->compact_length[i] = strlen(compact_str);
+        next->versions[i] = version;
+
+        // Large documents are compressed once per version for every HTTP reader that accepts gzip
+        free(next->gzip_json[i]);
+        next->gzip_json[i] = NULL;
+        next->gzip_length[i] = 0;
+        if (current->gzip_json[i] != NULL && current->versions[i] == version) {
+            next->gzip_json[i] = malloc(current->gzip_length[i]);
+            if (next->gzip_json[i] != NULL) {
+                memcpy(next->gzip_json[i], current->gzip_json[i], current->gzip_length[i]);
+                next->gzip_length[i] = current->gzip_length[i];
+            }
+        } else if (next->json_length[i] >= STORE_GZIP_MIN_LENGTH) {
+            next->gzip_json[i] = gzip_compress((const unsigned char*)json_str, next->json_length[i],
+                                               &next->gzip_length[i]);
+        }
+
+        // Binary records follow the same versioning as the JSON
+        next->binary_length[i] = 0;
+        if (store->binary_encoder != NULL) {
+            if (next->binary[i] == NULL) {
+                next->binary[i] = malloc(STORE_MAX_BINARY_LENGTH);
+            }
+            if (current->binary[i] != NULL && current->versions[i] == version) {
+                memcpy(next->binary[i], current->binary[i], current->binary_length[i]);
+                next->binary_length[i] = current->binary_length[i];
+            } else if (next->binary[i] != NULL) {
+                next->binary_length[i] = store->binary_encoder(store, i, next->binary[i], STORE_MAX_BINARY_LENGTH,
+                                                               store->binary_encoder_context);
+            }
+        }
+    }
+
+    // Deltas always end at the version just published, a reader without a matching one gets the full document
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        for (int j = 0; j < next->delta_count[i]; j++) {
+            free(next->delta_json[i][j]);
+        }
+        next->delta_count[i] = 0;
+
+        for (int j = 0; j < store->delta_request_count[i]; j++) {
+            uint64_t base_version = store->delta_requests[i][j];
+            bool current_version = next->versions[i] == store->datasets[i].version;
+            char* delta_str = current_version && base_version < next->versions[i]
+                                  ? build_delta(store, i, base_version) : NULL;
+            if (delta_str == NULL) continue;
+
+            int index = next->delta_count[i]++;
+            next->delta_json[i][index] = delta_str;
+            next->delta_length[i][index] = strlen(delta_str);
+            next->delta_base_versions[i][index] = base_version;
+        }
+        store->delta_request_count[i] = 0;
+    }
+
+    atomic_store(&store->active_snapshot, 1 - active);
+
+    store_unlock(store);
+    return true;
+}
+
+/**
+ * Sets the encoder that builds the binary record of each dataset whenever a snapshot is published.
+ * Every dataset is marked as changed so the records are built by the next publish.
+ *
+ * @param store Store to encode
+ * @param encoder Encoder to call, NULL to stop building binary records
+ * @param context Passed to every call of the encoder
+ */
+void store_set_binary_encoder(struct telemetry_store_t* store, store_binary_encoder_t encoder, void* context) {
+    if (!store) return;
+
+    store_lock(store);
+    store->binary_encoder = encoder;
+    store->binary_encoder_context = context;
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        store->datasets[i].version++;
+    }
+    store_publish_snapshot(store);
+    store_unlock(store);
+}
+
+/**
+ * Asks the next publish for a delta of a dataset from a version a reader already has, such as the last
+ * version sent to a stream. Requests only last for one publish, so readers repeat them after every publish
+ * and deltas are only built while someone uses them.
+ *
+ * @param store Store to publish
+ * @param dataset Dataset the reader follows
+ * @param base_version Version the delta should apply to
+ */
+void store_request_delta(struct telemetry_store_t* store, store_dataset_t dataset, uint64_t base_version) {
+    if (!store || base_version == 0) return;
+
+    store_lock(store);
+    int count = store->delta_request_count[dataset];
+    bool requested = false;
+    for (int i = 0; i < count; i++) {
+        requested |= store->delta_requests[dataset][i] == base_version;
+    }
+    if (!requested && count < STORE_MAX_DELTA_BASES) {
+        store->delta_requests[dataset][count] = base_version;
+        store->delta_request_count[dataset] = count + 1;
+    }
+    store_unlock(store);
+}
+
+/**
+ * Looks up the delta of a dataset from base_version to the snapshot's version.
+ *
+ * @param snapshot Snapshot held by the caller
+ * @param dataset Dataset to look up
+ * @param base_version Version the reader has
+ * @param length Set to the length of the delta
+ * @return Compact JSON merge patch, or NULL if the snapshot has none from base_version
+ */
+const char* store_snapshot_delta(const struct telemetry_snapshot_t* snapshot, store_dataset_t dataset,
+                                 uint64_t base_version, size_t* length) {
+    for (int i = 0; i < snapshot->delta_count[dataset]; i++) {
+        if (snapshot->delta_base_versions[dataset][i] == base_version) {
+            *length = snapshot->delta_length[dataset][i];
+            return snapshot->delta_json[dataset][i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Returns the latest published snapshot without taking the store lock. Every call must be paired with
+ * store_release_snapshot, the snapshot stays valid and unchanged until then.
+ *
+ * @param store Store to read from
+ * @return Current snapshot
+ */
+const struct telemetry_snapshot_t* store_acquire_snapshot(struct telemetry_store_t* store) {
+    while (true) {
+        int active = atomic_load(&store->active_snapshot);
+        struct telemetry_snapshot_t* snapshot = &store->snapshots[active];
+        atomic_fetch_add(&snapshot->readers, 1);
+
+        // The writer only rebuilds the inactive snapshot, so if this one is still active it is safe to use
+        if (atomic_load(&store->active_snapshot) == active) {
+            return snapshot;
+        }
+        atomic_fetch_sub(&snapshot->readers, 1);
+    }
+}
+
+/**
+ * Releases a snapshot returned by store_acquire_snapshot.
+ */
+void store_release_snapshot(const struct telemetry_snapshot_t* snapshot) {
+    atomic_fetch_sub(&((struct telemetry_snapshot_t*)snapshot)->readers, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                 Persistence
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Writes a file next to its destination and renames it into place, so readers of the data folder
+ * always see either the previous or the new complete file and never a truncated one.
+ *
+ * @param file_path Destination path
+ * @param contents Null-terminated file contents
+ * @return true if the file was replaced
+ */
+static bool write_file_atomically(const char* file_path, const char* contents) {
+    char temp_path[110];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", file_path);
+
+    FILE* fp = fopen(temp_path, "w");
+    if (fp == NULL) {
+        printf("Error: Unable to open the file %s for writing.\n", temp_path);
+        return false;
+    }
+
+    bool written = fputs(contents, fp) >= 0;
+    written = (fclose(fp) == 0) && written;
+
+    if (!written || rename(temp_path, file_path) != 0) {
+        printf("Error: Failed to replace %s.\n", file_path);
+        remove(temp_path);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Writes every dataset that changed since it was last persisted back to the data folder.
+ * The documents are taken from the latest snapshot, so persisting never holds the store lock.
+ * Unchanged datasets are skipped, so calling this often costs nothing while values are idle.
+ *
+ * @param store Store to persist
+ */
+void store_persist_dirty(struct telemetry_store_t* store) {
+    if (!store) return;
+
+    for (int i = 0; i < STORE_DATASET_COUNT; i++) {
+        struct telemetry_dataset_t* dataset = &store->datasets[i];
+
+        // Copy the document out so the snapshot is not held during the disk write
+        const struct telemetry_snapshot_t* snapshot = store_acquire_snapshot(store);
+        uint64_t version = snapshot->versions[i];
+        char* json_str = NULL;
+        if (version != dataset->persisted_version && snapshot->json[i] != NULL) {
+            json_str = strdup(snapshot->json[i]);
+        }
+        store_release_snapshot(snapshot);
+
+        if (json_str == NULL) {
+            continue;
+        }
+
+        char file_path[100];
+        snprintf(file_path, sizeof(file_path), STORE_DATA_ROOT "/%s.json", dataset->name);
+
+        if (write_file_atomically(file_path, json_str)) {
+            dataset->persisted_version = version;
+        }
+
+        free(json_str);
+    }
+}
+
+/**
+ * Persistence thread, coalesces every change made during an interval into a single write per file.
+ */
+static void* flusher_thread(void* arg) {
+    struct telemetry_store_t* store = (struct telemetry_store_t*)arg;
+
+    pthread_mutex_lock(&store->flusher_mutex);
+    while (store->flusher_running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += store->flush_interval_ms / 1000;
+        deadline.tv_nsec += (long)(store->flush_interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        // Sleep for one interval, or until the store is shutting down
+        while (store->flusher_running &&
+               pthread_cond_timedwait(&store->flusher_wake, &store->flusher_mutex, &deadline) == 0) {
+        }
+
+        pthread_mutex_unlock(&store->flusher_mutex);
+        store_persist_dirty(store);
+        pthread_mutex_lock(&store->flusher_mutex);
+    }
+    pthread_mutex_unlock(&store->flusher_mutex);
+
+    return NULL;
+}
+
+/**
+ * Starts the write-behind thread that keeps the data folder in sync with the store.
+ *
+ * @param store Store to persist
+ * @param interval_ms Minimum time between two writes of the same file
+ * @return true if the thread was started
+ */
+bool store_start_flusher(struct telemetry_store_t* store, int interval_ms) {
+    if (!store || store->flusher_running) return false;
+
+    store->flush_interval_ms = interval_ms > 0 ? interval_ms : STORE_DEFAULT_FLUSH_INTERVAL_MS;
+    store->flusher_running = true;
+
+    if (pthread_create(&store->flusher, NULL, flusher_thread, store) != 0) {
+        printf("Error: Failed to start the data persistence thread\n");
+        store->flusher_running = false;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Stops the write-behind thread and writes out anything that is still pending.
+ *
+ * @param store Store to stop persisting
+ */
+void store_stop_flusher(struct telemetry_store_t* store) {
+    if (!store) return;
+
+    pthread_mutex_lock(&store->flusher_mutex);
+    bool was_running = store->flusher_running;
+    store->flusher_running = false;
+    pthread_cond_signal(&store->flusher_wake);
+    pthread_mutex_unlock(&store->flusher_mutex);
+
+    if (was_running) {
+        pthread_join(store->flusher, NULL);
+    }
+
+    // Include changes made since the last publish in the final write
+    store_publish_snapshot(store);
+    store_persist_dirty(store);
+}
@@ -0,0 +1,179 @@
+#ifndef STORE_H
+#define STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "lib/cjson/cJSON.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Constants
+///////////////////////////////////////////////////////////////////////////////////
+
+#define STORE_DATA_ROOT "data"
+#define STORE_DEFAULT_FLUSH_INTERVAL_MS 500 // default time between writes of the same data file
+#define STORE_INVALID_HANDLE -1
+#define STORE_MAX_BINARY_LENGTH 4096 // largest fixed-layout binary record a dataset can have in a snapshot
+#define STORE_GZIP_MIN_LENGTH 1024 // pretty-printed documents at least this long are also kept gzip-compressed
+#define STORE_MAX_DELTA_BASES 8 // versions of a dataset a snapshot holds deltas from
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                  Structs
+///////////////////////////////////////////////////////////////////////////////////
+
+// Datasets held by the store, each one mirrors a file in the data folder
+typedef enum {
+    STORE_DATASET_EVA,
+    STORE_DATASET_ROVER,
+    STORE_DATASET_LTV,
+    STORE_DATASET_COUNT
+} store_dataset_t;
+
+// Handle to a resolved field path, an index into the store's slot table that stays valid while the server runs
+typedef int store_handle_t;
+
+struct telemetry_store_t;
+
+// Writes the fixed-layout binary record of a dataset into buffer, called with the store lock held while a
+// snapshot is built. Returns the record length, or 0 if the dataset has no binary form.
+typedef size_t (*store_binary_encoder_t)(struct telemetry_store_t* store, store_dataset_t dataset,
+                                         unsigned char* buffer, size_t capacity, void* context);
+
+struct telemetry_slot_t {
+    store_dataset_t dataset;
+    char* path;                  // dataset relative dot-separated path e.g. "pr_telemetry.brakes"
+    uint32_t hash;
+    cJSON* node;                 // item the path resolves to, NULL if it has to be looked up again
+    uint64_t changed_version;    // dataset version that last changed the item, 0 if it never changed
+};
+
+struct telemetry_dataset_t {
+    const char* name;            // file name without extension e.g. "EVA"
+    cJSON* root;                 // resident copy of the JSON document, source of truth while running
+    uint64_t version;            // incremented every time a value in the dataset changes
+    uint64_t persisted_version;  // version that was last written to disk, only used by the persistence thread
+    uint64_t untracked_version;  // last version with a change no slot records (an added item), deltas can't span it
+};
+
+// Immutable serialized view of every dataset, published by the writer and read without taking the store lock
+struct telemetry_snapshot_t {
+    atomic_int readers;                          // readers currently holding this snapshot
+    uint64_t versions[STORE_DATASET_COUNT];      // dataset versions the snapshot was built from
+    char* json[STORE_DATASET_COUNT];             // pretty-printed documents, same format as the data files
+    size_t json_length[STORE_DATASET_COUNT];
+    unsigned char* gzip_json[STORE_DATASET_COUNT]; // gzip of the pretty-printed documents, NULL when too short
+    size_t gzip_length[STORE_DATASET_COUNT];
+    char* compact_json[STORE_DATASET_COUNT];     // same documents without whitespace, sent to UDP clients
+    size_t compact_length[STORE_DATASET_COUNT];
+    unsigned char* binary[STORE_DATASET_COUNT];  // records from the binary encoder, NULL when there is none
+    size_t binary_length[STORE_DATASET_COUNT];
+
+    // Changed fields only, as compact JSON merge patches (RFC 7386) from each of delta_base_versions to versions,
+    // built for the versions readers asked for with store_request_delta
+    char* delta_json[STORE_DATASET_COUNT][STORE_MAX_DELTA_BASES];
+    size_t delta_length[STORE_DATASET_COUNT][STORE_MAX_DELTA_BASES];
+    uint64_t delta_base_versions[STORE_DATASET_COUNT][STORE_MAX_DELTA_BASES];
+    int delta_count[STORE_DATASET_COUNT];
+};
+
+// Resident telemetry state, loaded from the data folder once at startup
+struct telemetry_store_t {
+    struct telemetry_dataset_t datasets[STORE_DATASET_COUNT];
+
+    // Every field path seen so far, paths are resolved once through the hash table and then used by index
+    struct telemetry_slot_t* slots;
+    int slot_count;
+    int slot_capacity;
+    int* slot_table;             // open addressing table of slot indices, STORE_INVALID_HANDLE when empty
+    int slot_table_size;         // always a power of two
+    int* node_table;             // open addressing table of slot indices by item address, lets setters find their slot
+    int node_table_size;         // always a power of two
+    int node_table_used;         // entries in use, including ones whose slot has since moved to another item
+
+    // Recursive lock guarding the datasets, held by every reader and writer of the documents
+    pthread_mutex_t lock;
+
+    // Batched writes, datasets changed while a batch is open get a single version bump when it ends
+    int batch_depth;
+    unsigned int batch_modified; // bit n set when dataset n changed inside the batch
+
+    // Double-buffered snapshots, readers use snapshots[active_snapshot] while the writer rebuilds the other one
+    struct telemetry_snapshot_t snapshots[2];
+    atomic_int active_snapshot;
+
+    // Versions readers asked deltas from since the last publish, nothing is diffed when there are none
+    uint64_t delta_requests[STORE_DATASET_COUNT][STORE_MAX_DELTA_BASES];
+    int delta_request_count[STORE_DATASET_COUNT];
+
+    // Optional encoder for the binary records kept in each snapshot
+    store_binary_encoder_t binary_encoder;
+    void* binary_encoder_context;
+
+    // Write-behind persistence thread
+    pthread_t flusher;
+    pthread_mutex_t flusher_mutex;
+    pthread_cond_t flusher_wake;
+    bool flusher_running;
+    int flush_interval_ms;
+};
+
+///////////////////////////////////////////////////////////////////////////////////
+//                                 Functions
+///////////////////////////////////////////////////////////////////////////////////
+
+// Store lifecycle
+struct telemetry_store_t* store_create(void);
+void store_destroy(struct telemetry_store_t* store);
+
+// Locking
+void store_lock(struct telemetry_store_t* store);
+void store_unlock(struct telemetry_store_t* store);
+void store_begin_batch(struct telemetry_store_t* store);
+void store_end_batch(struct telemetry_store_t* store);
+
+// Lookup
+int store_dataset_from_name(const char* name);
+cJSON* store_get_root(struct telemetry_store_t* store, store_dataset_t dataset);
+cJSON* store_find(struct telemetry_store_t* store, store_dataset_t dataset, const char* path);
+cJSON* store_find_path(cJSON* object, const char* path);
+
+// Handles, reads and writes through a handle are O(1) and require the caller to hold the store lock
+store_handle_t store_resolve(struct telemetry_store_t* store, store_dataset_t dataset, const char* path);
+store_handle_t store_resolve_route(struct telemetry_store_t* store, const char* route);
+cJSON* store_handle_node(struct telemetry_store_t* store, store_handle_t handle);
+store_dataset_t store_handle_dataset(struct telemetry_store_t* store, store_handle_t handle);
+bool store_handle_get_number(struct telemetry_store_t* store, store_handle_t handle, double* value);
+bool store_handle_set_number(struct telemetry_store_t* store, store_handle_t handle, double value);
+bool store_handle_set_bool(struct telemetry_store_t* store, store_handle_t handle, bool value);
+bool store_handle_set_from_string(struct telemetry_store_t* store, store_handle_t handle, const char* value);
+
+// Mutation, every setter only bumps the dataset version when the value actually changes
+bool store_set_number(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* node, double value);
+bool store_set_bool(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* node, bool value);
+bool store_set_number_array(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* node,
+                            const double* values, int count);
+bool store_set_from_string(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* node,
+                           const char* value);
+cJSON* store_add_number(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* object,
+                        const char* name, double value);
+cJSON* store_get_or_add_object(struct telemetry_store_t* store, store_dataset_t dataset, cJSON* parent,
+                               const char* name);
+
+// Snapshots, readers never wait for the writer and the writer never waits for readers
+bool store_publish_snapshot(struct telemetry_store_t* store);
+void store_set_binary_encoder(struct telemetry_store_t* store, store_binary_encoder_t encoder, void* context);
+void store_request_delta(struct telemetry_store_t* store, store_dataset_t dataset, uint64_t base_version);
+const char* store_snapshot_delta(const struct telemetry_snapshot_t* snapshot, store_dataset_t dataset,
+                                 uint64_t base_version, size_t* length);
+const struct telemetry_snapshot_t* store_acquire_snapshot(struct telemetry_store_t* store);
+void store_release_snapshot(const struct telemetry_snapshot_t* snapshot);
+
+// Persistence
+void store_persist_dirty(struct telemetry_store_t* store);
+bool store_start_flusher(struct telemetry_store_t* store, int interval_ms);
+void store_stop_flusher(struct telemetry_store_t* store);
+
+#endif // STORE_H